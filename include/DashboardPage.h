@@ -8,9 +8,10 @@
 class DashboardPage
 {
 public:
-    static String getHTML()
+    // Page stockée en flash (PROGMEM) : envoyée avec send_P, sans copie en RAM
+    static PGM_P getHTML()
     {
-        String html = R"rawliteral(
+        static const char html[] PROGMEM = R"rawliteral(
 <!DOCTYPE html>
 <html lang="fr">
 <head>
@@ -116,17 +117,17 @@ public:
             <div class="time-row">
                 <span>Distribution automatique</span>
                 <label class="switch">
-                    <input type="checkbox" id="autoMiam" onchange="sendCmd('/setAutomiam', this.checked ? 1 : 0)">
+                    <input type="checkbox" id="autoMiam" onchange="saveSettings({ autoMiam: this.checked })">
                     <span class="slider"></span>
                 </label>
             </div> 
             <div class="time-row">
                 <span>Début de service</span>
-                <input type="time" id="timeStart" onchange="sendTime('start', this.value)">
+                <input type="time" id="timeStart" onchange="saveSettings({ timeStart: this.value })">
             </div>
             <div class="time-row">
                 <span>Fin de service</span>
-                <input type="time" id="timeEnd" onchange="sendTime('end', this.value)">
+                <input type="time" id="timeEnd" onchange="saveSettings({ timeEnd: this.value })">
             </div>
 
         </div>
@@ -137,74 +138,174 @@ public:
 
         function sendCmd(path, val) { fetch(path + '?v=' + val); }
 
-        function sendTime(type, val) {
-            fetch('/setMiamTime?type=' + type + '&val=' + val);
+        // Réglages regroupés : les modifications rapprochées partent en un seul POST /api/settings
+        let pendingSettings = {}, settingsTimer = null;
+        function saveSettings(changes) {
+            Object.assign(pendingSettings, changes);
+            clearTimeout(settingsTimer);
+            settingsTimer = setTimeout(() => {
+                const body = JSON.stringify(pendingSettings);
+                pendingSettings = {};
+                fetch('/api/settings', { method: 'POST', headers: { 'Content-Type': 'application/json' }, body: body })
+                    .then(r => r.json())
+                    .then(d => { if (d.error) { alert('Réglage refusé : ' + d.error); updateUI(); } });
+            }, 500);
+        }
+
+        // Etat complet du dashboard (rempli par /api/data, mis à jour par les deltas SSE)
+        let state = {};
+
+        // Historique [[t,m],...] tenu à jour par /api/history?since= (seuls les nouveaux points transitent)
+        // En cas d'échec : nouvel essai après 1 s, 2 s, 4 s... (1 min au plus). historyLoading reste
+        // vrai pendant l'attente : les deltas SSE reçus entre-temps ne relancent pas de requête
+        let history = [], historyNext = null, historyLoading = false, historyRetryMs = 0;
+        function fetchHistory(full) {
+            if (historyLoading) return;
+            historyLoading = true;
+            // Résolution adaptée à la largeur du graphique : un point tous les 4 pixels au plus
+            const maxPoints = Math.max(10, Math.floor(document.getElementById('chartBox').clientWidth / 4));
+            let url = '/api/history?maxPoints=' + maxPoints;
+            if (!full && historyNext !== null) url += '&since=' + historyNext;
+            fetch(url).then(r => {
+                if (!r.ok) throw new Error(r.status);
+                return r.json();
+            }).then(d => {
+                history = d.reset ? d.points : history.concat(d.points);
+                historyNext = d.next;
+                historyLoading = false;
+                historyRetryMs = 0;
+                renderChart(state);
+                if (state.hSeq !== undefined && state.hSeq !== historyNext) fetchHistory();
+            }).catch(() => {
+                historyRetryMs = Math.min(historyRetryMs ? historyRetryMs * 2 : 1000, 60000);
+                setTimeout(() => { historyLoading = false; fetchHistory(full); }, historyRetryMs);
+            });
+        }
+
+        // Heure du distributeur (secondes depuis minuit), extrapolée avec l'horloge du navigateur
+        let clock = { now: 0, at: Date.now() };
+        function setNow(now) { clock = { now: now, at: Date.now() }; renderClock(); }
+        function fetchNow() { fetch('/api/now').then(r => r.json()).then(d => setNow(d.now)); }
+        function nowSec() { return clock.now + Math.floor((Date.now() - clock.at) / 1000); }
+
+        // Même format que RTCManager::formatDuration ("2h 15m 30s")
+        function fmtDuration(sec) {
+            if (!(sec > 0)) return '0s';
+            const h = Math.floor(sec / 3600), m = Math.floor((sec % 3600) / 60), s = sec % 60;
+            return (h > 0 ? h + 'h ' : '') + (h > 0 || m > 0 ? m + 'm ' : '') + s + 's';
+        }
+
+        // Décomptes calculés localement : aucune requête réseau
+        function renderClock() {
+            if (state.tCroquettes === undefined) return;
+            const now = nowSec();
+            document.getElementById('hCroquettes').innerText = fmtDuration(now - state.tCroquettes);
+            document.getElementById('hCroquinettes').innerText = fmtDuration(now - state.tCroquinettes);
+            document.getElementById('hNextCroquettes').innerText = fmtDuration(state.tNextCroquettes - now);
+            document.getElementById('delay').innerText = fmtDuration(state.delaySec);
         }
 
         function updateUI() {
             fetch('/api/data').then(r => r.json()).then(data => {
-                for (let key in data) {
-                        let el = document.getElementById(key);
-                        if (el) {
-                            if (el.type === 'checkbox') el.checked = data[key];
-                            else if (el.type === 'time') {
-                                // On ne met à jour l'input que s'il n'est pas en train d'être modifié
-                                if (document.activeElement !== el) el.value = data[key];
-                            }
-                            else el.innerText = data[key];
-                        }
-                    }
-                // --- LOGIQUE DU GRAPHIQUE ---
-                if (data.history && data.timeStart && data.timeEnd) {
-                    const rationMax = data.ration + 10 || 100;
-                    
-                    // Conversion des bornes temporelles en secondes
-                    const getSec = (t) => { let s = t.split(':'); return parseInt(s[0])*3600 + parseInt(s[1])*60; };
-                    const tStart = getSec(data.timeStart);
-                    const tEnd = getSec(data.timeEnd);
-                    const tRange = tEnd - tStart;
-
-                    // 1. Dessiner la grille
-                    let gridHTML = '';
-                    // Abscisses : Chaque heure
-                    let hStart = parseInt(data.timeStart.split(':')[0]);
-                    let hEnd = parseInt(data.timeEnd.split(':')[0]);
-                    for (let h = hStart; h <= hEnd; h++) {
-                        let x = ((h * 3600 - tStart) / tRange) * 100;
-                        if (x >= 0 && x <= 100) {
-                            gridHTML += `<line class="grid-line" x1="${x}" y1="0" x2="${x}" y2="100"></line>`;
-                            gridHTML += `<text class="axis-text" x="${x}" y="105" text-anchor="middle">${h}h</text>`;
+                state = data;
+                render(state);
+            });
+        }
+
+        // Applique un delta poussé par /api/events
+        function applyDelta(delta) {
+            Object.assign(state, delta);
+            render(state);
+        }
+
+        function render(data) {
+            for (let key in data) {
+                    let el = document.getElementById(key);
+                    if (el) {
+                        if (el.type === 'checkbox') el.checked = data[key];
+                        else if (el.type === 'time') {
+                            // On ne met à jour l'input que s'il n'est pas en train d'être modifié
+                            if (document.activeElement !== el) el.value = data[key];
                         }
+                        else el.innerText = data[key];
                     }
-                    // Ordonnées : Graduations tous les 10g
-                    for (let g = 0; g <= rationMax; g += 10) {
-                        let y = 100 - (g / rationMax * 100);
-                        gridHTML += `<line class="grid-line" x1="0" y1="${y}" x2="100" y2="${y}"></line>`;
-                        gridHTML += `<text class="axis-text" x="-2" y="${y + 1}" text-anchor="end">${g}g</text>`;
-                    }
-                    document.getElementById('chartGrid').innerHTML = gridHTML;
-
-                    // 2. Calcul des points
-                    const pointsArray = data.history.map(p => {
-                        let x = ((p.t - tStart) / tRange) * 100;
-                        let y = 100 - (p.m / rationMax * 100);
-                        // On bride X entre 0 et 100 pour rester dans la plage de miam
-                        return { x: Math.max(0, Math.min(100, x)), y: y, m: p.m, t: p.t };
-                    });
-
-                    const pointsStr = pointsArray.map(p => `${p.x},${p.y}`).join(" ");
-                    document.getElementById('chartLine').setAttribute("points", pointsStr);
-                    
-                    if(pointsArray.length > 0) {
-                        const areaPath = `M 0,100 L ${pointsStr} L ${pointsArray[pointsArray.length-1].x},100 Z`;
-                        document.getElementById('chartArea').setAttribute("d", areaPath);
+                }
+            renderClock();
+            if (data.hSeq !== undefined && data.hSeq !== historyNext) fetchHistory();
+            renderChart(data);
+        }
+
+        function renderChart(data) {
+            // --- LOGIQUE DU GRAPHIQUE ---
+            if (data.timeStart && data.timeEnd) {
+                const rationMax = data.ration + 10 || 100;
+                
+                // Conversion des bornes temporelles en secondes
+                const getSec = (t) => { let s = t.split(':'); return parseInt(s[0])*3600 + parseInt(s[1])*60; };
+                const tStart = getSec(data.timeStart);
+                const tEnd = getSec(data.timeEnd);
+                const tRange = tEnd - tStart;
+
+                // 1. Dessiner la grille
+                let gridHTML = '';
+                // Abscisses : Chaque heure
+                let hStart = parseInt(data.timeStart.split(':')[0]);
+                let hEnd = parseInt(data.timeEnd.split(':')[0]);
+                for (let h = hStart; h <= hEnd; h++) {
+                    let x = ((h * 3600 - tStart) / tRange) * 100;
+                    if (x >= 0 && x <= 100) {
+                        gridHTML += `<line class="grid-line" x1="${x}" y1="0" x2="${x}" y2="100"></line>`;
+                        gridHTML += `<text class="axis-text" x="${x}" y="105" text-anchor="middle">${h}h</text>`;
                     }
                 }
-                // --- FIN LOGIQUE DU GRAPHIQUE ---
-            });
+                // Ordonnées : Graduations tous les 10g
+                for (let g = 0; g <= rationMax; g += 10) {
+                    let y = 100 - (g / rationMax * 100);
+                    gridHTML += `<line class="grid-line" x1="0" y1="${y}" x2="100" y2="${y}"></line>`;
+                    gridHTML += `<text class="axis-text" x="-2" y="${y + 1}" text-anchor="end">${g}g</text>`;
+                }
+                document.getElementById('chartGrid').innerHTML = gridHTML;
+
+                // 2. Calcul des points
+                const pointsArray = history.map(p => {
+                    let x = ((p[0] - tStart) / tRange) * 100;
+                    let y = 100 - (p[1] / rationMax * 100);
+                    // On bride X entre 0 et 100 pour rester dans la plage de miam
+                    return { x: Math.max(0, Math.min(100, x)), y: y, m: p[1], t: p[0] };
+                });
+
+                const pointsStr = pointsArray.map(p => `${p.x},${p.y}`).join(" ");
+                document.getElementById('chartLine').setAttribute("points", pointsStr);
+                
+                if(pointsArray.length > 0) {
+                    const areaPath = `M 0,100 L ${pointsStr} L ${pointsArray[pointsArray.length-1].x},100 Z`;
+                    document.getElementById('chartArea').setAttribute("d", areaPath);
+                }
+            }
+            // --- FIN LOGIQUE DU GRAPHIQUE ---
+        }
+
+        // Push SSE, avec repli sur le polling si le flux est indisponible
+        let pollTimer = null;
+        function startPolling() {
+            if (!pollTimer) pollTimer = setInterval(() => { updateUI(); if (Date.now() - clock.at > 60000) fetchNow(); }, 1000);
+        }
+        function stopPolling() {
+            if (pollTimer) { clearInterval(pollTimer); pollTimer = null; }
+        }
+        if (window.EventSource) {
+            const events = new EventSource('/api/events');
+            events.addEventListener('state', e => applyDelta(JSON.parse(e.data)));
+            events.addEventListener('now', e => setNow(JSON.parse(e.data).now));
+            events.addEventListener('resync', () => updateUI());
+            events.onopen = () => { stopPolling(); updateUI(); fetchNow(); fetchHistory(true); };
+            events.onerror = () => startPolling();
+        } else {
+            startPolling();
         }
-        setInterval(updateUI, 1000);
+        setInterval(renderClock, 1000);
         updateUI();
+        fetchNow();
     </script>
 </body>
 </html>
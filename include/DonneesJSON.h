@@ -0,0 +1,101 @@
+#ifndef DONNEES_JSON_H
+#define DONNEES_JSON_H
+
+#include <Arduino.h>
+
+/* État du distributeur exposé par /api/data, historique exposé par /api/history
+Copie des variables globales faite par main.cpp : la sérialisation ne dépend que de Print
+et se teste sur PC (pio test -e native, voir test/test_donnees_json).
+*/
+struct DonneesDistributeur
+{
+  unsigned long version;
+  unsigned int nbCroquettes;
+  unsigned int nbCroquinettes;
+  unsigned long tCroquettes;   // Secondes depuis minuit
+  unsigned long tCroquinettes; // Secondes depuis minuit
+  unsigned long delaySec;      // Délai courant entre deux distributions de croquettes
+  unsigned int absences;       // Reports de la prochaine distribution (chat absent)
+  unsigned long snoozeSec;     // Durée d'un report
+  int mass;
+  int ration;
+  boolean autoMiam;
+  int heureDebut;
+  int minuteDebut;
+  int heureFin;
+  int minuteFin;
+  unsigned long hSeq; // Curseur pour /api/history?since=
+};
+
+// Point de l'historique de la journée (/api/history)
+struct FeedingTime
+{
+  unsigned long timestamp; // Secondes depuis minuit
+  int cumulativeMass;      // Masse totale à cet instant
+};
+
+/* Sérialisation JSON de l'état, écrite directement dans un Print (tampon fixe ou socket)
+Aucun JsonDocument ni String : uniquement des valeurs numériques brutes et
+des print() de taille bornée (printf reste sous les 64 octets du tampon de Print).
+*/
+inline void ecrireDonneesJSON(Print &out, const DonneesDistributeur &d)
+{
+  out.print(F("{\"version\":"));
+  out.print(d.version);
+  out.print(F(",\"nbCroquettes\":"));
+  out.print(d.nbCroquettes);
+  out.print(F(",\"nbCroquinettes\":"));
+  out.print(d.nbCroquinettes);
+  out.print(F(",\"tCroquettes\":"));
+  out.print(d.tCroquettes);
+  out.print(F(",\"tCroquinettes\":"));
+  out.print(d.tCroquinettes);
+  out.print(F(",\"tNextCroquettes\":"));
+  out.print(d.tCroquettes + d.delaySec + d.absences * d.snoozeSec);
+  out.print(F(",\"delaySec\":"));
+  out.print(d.delaySec);
+  out.print(F(",\"mass\":"));
+  out.print(d.mass);
+  out.print(F(",\"ration\":"));
+  out.print(d.ration);
+  out.print(F(",\"autoMiam\":"));
+  out.print(d.autoMiam ? F("true") : F("false"));
+  // Plage horaire au format des inputs (ex: "07:30")
+  out.printf(",\"timeStart\":\"%02d:%02d\"", d.heureDebut, d.minuteDebut);
+  out.printf(",\"timeEnd\":\"%02d:%02d\"", d.heureFin, d.minuteFin);
+  out.print(F(",\"hSeq\":"));
+  out.print(d.hSeq);
+  out.print('}');
+}
+
+// Points d'historique [debut, fin[ en [[t,m],...], sans allocation
+inline void ecrireHistoriqueJSON(Print &out, const FeedingTime *points, int debut, int fin)
+{
+  out.print('[');
+  for (int i = debut; i < fin; i++)
+  {
+    if (i > debut)
+    {
+      out.print(',');
+    }
+    out.printf("[%lu,%d]", points[i].timestamp, points[i].cumulativeMass);
+  }
+  out.print(']');
+}
+
+// Points choisis par le sous-échantillonnage (indices croissants)
+inline void ecrireHistoriqueJSON(Print &out, const FeedingTime *points, const uint8_t *indices, int nombre)
+{
+  out.print('[');
+  for (int i = 0; i < nombre; i++)
+  {
+    if (i > 0)
+    {
+      out.print(',');
+    }
+    out.printf("[%lu,%d]", points[indices[i]].timestamp, points[indices[i]].cumulativeMass);
+  }
+  out.print(']');
+}
+
+#endif // DONNEES_JSON_H
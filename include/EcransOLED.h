@@ -0,0 +1,71 @@
+#ifndef ECRANS_OLED_H
+#define ECRANS_OLED_H
+
+#include <Arduino.h>
+#include <OLEDDisplay.h>
+
+/* Écrans de bord dessinés par ScreenManager (SCREEN_HOME, SCREEN_INFO)
+Copie de l'heure et des compteurs faite par main.cpp : le dessin ne dépend que d'OLEDDisplay
+et se compare à des images de référence sur PC (pio test -e native, voir test/test_oled).
+*/
+struct DonneesEcrans
+{
+  uint8_t jour;
+  uint8_t mois;
+  uint16_t annee;
+  uint8_t heure;
+  uint8_t minute;
+  uint8_t signalWifi;                 // 0-4 (getWiFiSignalLevel)
+  unsigned long prochainesCroquettes; // Secondes depuis minuit, au-delà de 24 h le lendemain
+  float progression;                  // Part de la ration quotidienne mangée (%)
+  unsigned int nbCroquettes;
+  unsigned int nbCroquinettes;
+  unsigned long tCroquettes;   // Secondes depuis minuit
+  unsigned long tCroquinettes; // Secondes depuis minuit
+};
+
+// Même format que RTCManager::formatSecondsToTime(secondes, false) : "07h30"
+inline const char *formaterHeureEcran(char (&tampon)[8], unsigned long secondes)
+{
+  secondes = secondes % 86400;
+  snprintf(tampon, sizeof(tampon), "%02uh%02u", (unsigned)(secondes / 3600), (unsigned)((secondes % 3600) / 60));
+  return tampon;
+}
+
+inline void dessinerEcranAccueil(OLEDDisplay &oled, const DonneesEcrans &d)
+{
+  char heure[8];
+
+  // En-tête avec indicateur de WiFi
+  oled.printDate(d.jour, d.mois, d.annee, ALIGN_LEFT, 0);
+  oled.drawWifiSignal(115, 0, d.signalWifi);
+
+  // Heure actuelle
+  oled.printTime(d.heure, d.minute, ALIGN_CENTER, 17, 2);
+
+  // Prochaine distribution
+  oled.printTextAligned("Prochain croq:", ALIGN_LEFT, 40);
+  oled.printTextAligned(formaterHeureEcran(heure, d.prochainesCroquettes), ALIGN_RIGHT, 40);
+
+  // Barre de progression
+  oled.drawProgressBarBottom(d.progression, true);
+}
+
+inline void dessinerEcranInfo(OLEDDisplay &oled, const DonneesEcrans &d)
+{
+  char heure[8];
+
+  // En-tête avec indicateur de WiFi
+  oled.printText("Compteurs", 0, 0, 1);
+  oled.drawWifiSignal(115, 0, d.signalWifi);
+
+  oled.printTextAligned("Croquettes", ALIGN_LEFT, 20);
+  oled.printValue(" - ", d.nbCroquettes, 0, "", 30);
+  oled.printTextAligned(formaterHeureEcran(heure, d.tCroquettes), ALIGN_RIGHT, 30);
+
+  oled.printTextAligned("Croquinettes", ALIGN_LEFT, 46);
+  oled.printValue(" - ", d.nbCroquinettes, 0, "", 56);
+  oled.printTextAligned(formaterHeureEcran(heure, d.tCroquinettes), ALIGN_RIGHT, 56);
+}
+
+#endif // ECRANS_OLED_H
@@ -4,19 +4,27 @@
 #define CONFIG_H
 
 #include <Arduino.h>
-#include <Servo.h>       // Servomoteur
 #include <Preferences.h> // Persistent memory
 #include <ArduinoJson.h>
 
 // --- INCLUSIONS PERSO ---
 #include <WiFiManager.h>
+#include <ResponseWriter.h>
+#include <EventStream.h>
+#include <Metrics.h>
+#include <CommandQueue.h>
 #include <OTAManager.h>
 #include <RTCManager.h>
 #include <OLEDDisplay.h>
+#include <BootTimeline.h>
+#include <ScreenManager.h>
 #include <InputBouton.h>
+#include <ServoDriver.h>
 #include "DashboardPage.h"
 
 #include "debug.h"
+#include "DonneesJSON.h" // Sérialisation de /api/data et /api/history
+#include "EcransOLED.h"  // Écrans de bord (accueil, compteurs)
 #include "images.h" //  image de chat
 #include "secrets.h"
 
@@ -25,12 +33,25 @@ const char *NTP_SERVER = "pool.ntp.org";
 const long GMT_OFFSET_SEC = 3600;
 const int DAYLIGHT_OFFSET_SEC = 0;
 
+// --- SERVEUR WEB ---
+const uint8_t MAX_FLUX_SSE = 2;                // Nombre maximum de dashboards connectés en SSE (/api/events)
+const unsigned long SSE_CONTROLE_MS = 250;     // Période de détection des changements d'état
+const unsigned long SSE_TICK_MS = 30 * 1000UL; // Période de rafraîchissement des décomptes
+
 // --- SERVOMOTEUR ---
 #define SERVO_PIN D3
 const int ANGLE_OUVERTURE = 180;       // Angle pour ouvrir la valve
 const int ANGLE_FERMETURE = 60;        // Angle pour fermer la valve
 const unsigned int CROQUINETTES = 111; // temps  (ms) ouverture rapide
 const unsigned int CROQUETTES = 500;   // temps (ms) ouverture longue
+const uint16_t SERVO_RAMPE_OUVERTURE_MS = 120; // Rampe d'ouverture, comprise dans le temps d'ouverture (raccourcie si plus long)
+const uint16_t SERVO_RAMPE_FERMETURE_MS = 200; // Rampe de fermeture
+const uint16_t SERVO_STABILISATION_MS = 300;   // Après la fermeture : le servo est détaché (plus de PWM)
+const int SECOUSSE_AMPLITUDE = -25;            // Secousse avant fermeture, en degrés, contre les voûtes de croquettes
+const uint8_t SECOUSSE_CYCLES = 0;             // 0 : pas de secousse (sinon, recalibrer les portions)
+const uint16_t SECOUSSE_PERIODE_MS = 120;
+// Ouverture, maintien, secousse et fermeture doivent tenir dans la séquence du servo
+static_assert(3 + 2 * SECOUSSE_CYCLES <= ServoDriver::MAX_SEGMENTS, "SECOUSSE_CYCLES trop grand pour ServoDriver::MAX_SEGMENTS");
 
 // --- RTC (DS1302) ---
 #define DS1302_CLK_PIN D7
@@ -45,6 +66,8 @@ const unsigned int CROQUETTES = 500;   // temps (ms) ouverture longue
 #define SCREEN_HEIGHT 64        // Taille de l'écran OLED, en pixel, au niveau de sa hauteur
 #define OLED_RESET_PIN -1       // Reset de l'OLED partagé avec l'Arduino (d'où la valeur à -1, et non un numéro de pin)
 #define OLED_I2C_ADRESS 0x3C    // Adresse de "mon" écran OLED sur le bus i2c (généralement égal à 0x3C ou 0x3D)
+#define OLED_I2C_CLOCK 400000   // Fréquence du bus i2c (Hz) : 400 kHz en mode rapide, certains écrans acceptent 800 kHz et plus
+#define OLED_FLUSH_BUDGET_US 2000 // Temps d'envoi vers l'écran par passage dans loop() (µs)
 const int DISPLAY_TIME_SEC = 5; // Temps d'affichage en secondes
 
 // Bouton Tactile TTP223
@@ -60,6 +83,9 @@ boolean autoMiamActivated = true;                            // Activer ou désa
 const unsigned long FEED_DELAY_CROQUETTES_SEC = 2 * 60 * 60; // Délai minimum entre deux distributions (2 heures)
 const unsigned long FEED_DELAY_CROQUINETTES_SEC = 60;        // 30 * 60;   // Délai minimum entre deux distributions rapides (30 minutes)
 const unsigned long SNOOZE_DELAY_SEC = 30;                   // 30 * 60;              // Délai en cas de présence de croquettes (30 minutes)
+unsigned long feedDelayCroquettesSec = FEED_DELAY_CROQUETTES_SEC;     // Réglage courant (POST /api/settings), persisté
+unsigned long feedDelayCroquinettesSec = FEED_DELAY_CROQUINETTES_SEC; // Réglage courant (POST /api/settings), persisté
+unsigned long snoozeDelaySec = SNOOZE_DELAY_SEC;                      // Réglage courant (POST /api/settings), persisté
 unsigned long lastFeedTimeCroquettes = 0;                    // Dernier temps (en secondes depuis minuit) où le chat a été nourri avec des croquettes
 unsigned long lastFeedTimeCroquinettes = 0;                  // Dernier temps (en secondes depuis minuit) où le chat a été nourri avec quelques croquinettes
 unsigned int compteurAbsenceChat = 0;                        // Nombre de reports de distributions de croquettes
@@ -70,17 +96,122 @@ unsigned int compteurDeCroquinettes = 0;                     // Nombre de distri
 const int RATION_QUOTIDIENNE_G = 75; // Ration quotidienne (en g) idéale pour El Gazou
 const int RATION_CROQUETTES_G = 5;   // Ration croquettes (en g) par distribution
 const int RATION_CROQUINETTES_G = 1; // Ration croquinettes (en g) par distribution
+int rationQuotidienneG = RATION_QUOTIDIENNE_G;   // Réglages courants (POST /api/settings), persistés
+int rationCroquettesG = RATION_CROQUETTES_G;
+int rationCroquinettesG = RATION_CROQUINETTES_G;
 int masseEngloutieParLeChatEnG = 0;
 unsigned long delayDistributionCroquettesSec = FEED_DELAY_CROQUETTES_SEC;
 
 // --- HISTORIQUE ---
-struct FeedingTime
-{
-    unsigned long timestamp; // Secondes depuis minuit
-    int cumulativeMass;      // Masse totale à cet instant
-};
+// FeedingTime : DonneesJSON.h
 const int MAX_HISTORY_POINTS = 30; // Suffisant pour une journée
 FeedingTime feedingHistory[MAX_HISTORY_POINTS];
 int historySize = 0;
+unsigned long historySeqDebut = 0; // Numéro de séquence de feedingHistory[0] (croissant depuis le boot)
+
+
+// --- VERSION DE L'ETAT ---
+unsigned long etatVersion = 1;     // Incrémentée à chaque modification de l'état du distributeur
+uint32_t identifiantDemarrage = 0; // Aléatoire à chaque démarrage : rend les ETag uniques entre deux boots
+const size_t TAILLE_CACHE_DONNEES = 512; // Corps de /api/data : ~220 octets, 292 avec les plus grandes valeurs
+
+// --- EVENEMENTS (SSE) ---
+struct EtatPublie // Dernier état poussé aux dashboards, pour n'envoyer que les différences
+{
+    unsigned int nbCroquettes;
+    unsigned int nbCroquinettes;
+    unsigned long lastCroquettes;
+    unsigned long lastCroquinettes;
+    unsigned long delay;
+    unsigned int absences;
+    unsigned long snooze;
+    int mass;
+    int ration;
+    boolean autoMiam;
+    int debutMiam; // Minutes depuis minuit
+    int finMiam;   // Minutes depuis minuit
+    unsigned long historySeq; // Prochain numéro de séquence de l'historique
+};
+
+// --- DEMARRAGE ---
+enum PhaseDemarrage // Étapes du démarrage, dans l'ordre où elles sont normalement prêtes
+{
+    PHASE_ECRAN,        // Écran initialisé, image de démarrage affichée
+    PHASE_MEMOIRE,      // Réglages et compteurs relus (Preferences)
+    PHASE_HORLOGE,      // RTC lu : heure locale disponible, pas encore synchronisée
+    PHASE_DISTRIBUTION, // Servo, bouton et file de commandes : le chat peut être nourri
+    PHASE_WIFI,         // Connecté au réseau
+    PHASE_WEB,          // Serveur web et OTA attachés (réseau ou point d'accès de secours)
+    PHASE_NTP,          // RTC synchronisé sur l'heure réseau
+    NB_PHASES
+};
+const char *const NOMS_PHASES[NB_PHASES] = {"ecran", "memoire", "horloge", "distribution", "wifi", "web", "ntp"};
+unsigned long phasePreteMs[NB_PHASES] = {};          // millis() à la fin de chaque phase (0 : pas encore prête)
+const unsigned long NTP_DELAI_MAX_MS = 30 * 1000UL; // Après la connexion : message d'échec si l'heure réseau n'est pas arrivée
+int8_t etapeLiaisonWifi = -1;                     // Étapes du chronométrage (/api/boot) terminées dans loop()
+int8_t etapeNtp = -1;
+const unsigned long CHRONO_DEMARRAGE_MAX_MS = 2 * 60 * 1000UL; // Chronologie enregistrée au plus tard après ce délai
+// #define CALIBRATION_AU_DEMARRAGE                  // Calibration du distributeur à chaque démarrage (~3 min, bloquante, désactive l'auto-miam)
+
+// --- FILE DE COMMANDES ---
+enum TypeCommande
+{
+    COMMANDE_DISTRIBUTION // arg : (0) Croquinettes || (1) Croquettes
+};
+const unsigned long COMMANDES_REGROUPEMENT_MS = 2000; // Une demande identique dans ce délai est refusée
+
+// --- METRIQUES (/metrics) ---
+enum SourceCommande // Origine d'une demande de distribution
+{
+    SOURCE_WEB,
+    SOURCE_BOUTON,
+    SOURCE_AUTO,
+    NB_SOURCES
+};
+enum ResultatDistribution // Issue d'une demande de distribution
+{
+    DISTRIBUTION_CROQUETTES,
+    DISTRIBUTION_CROQUINETTES,
+    DISTRIBUTION_REPORTEE,     // Croquettes encore présentes : snooze
+    REFUS_CROQUETTES_PRESENTES, // Pas de croquinettes si la gamelle n'est pas vide
+    REFUS_REGIME,
+    REFUS_DELAI,               // Délai des croquinettes non écoulé
+    REFUS_DOUBLON,             // Demande identique déjà en file (CommandQueue)
+    NB_RESULTATS
+};
+const char *const NOMS_SOURCES[NB_SOURCES] = {"web", "bouton", "auto"};
+const char *const NOMS_RESULTATS[NB_RESULTATS] = {"croquettes", "croquinettes", "reportee", "refus_presence", "refus_regime", "refus_delai", "refus_doublon"};
+unsigned long compteursDistribution[NB_SOURCES][NB_RESULTATS] = {};
+LatencyHistogram latenceBoucle; // Intervalle entre deux passages dans loop()
+
+// Preferences qui compte les écritures en flash (usure de l'EEPROM émulée)
+class PreferencesComptees : public Preferences
+{
+public:
+    size_t putBool(const char *key, bool value)
+    {
+        ecritures++;
+        return Preferences::putBool(key, value);
+    }
+    size_t putInt(const char *key, int32_t value)
+    {
+        ecritures++;
+        return Preferences::putInt(key, value);
+    }
+    size_t putUInt(const char *key, uint32_t value)
+    {
+        ecritures++;
+        return Preferences::putUInt(key, value);
+    }
+    size_t putULong(const char *key, uint32_t value)
+    {
+        ecritures++;
+        return Preferences::putULong(key, value);
+    }
+    unsigned long getEcritures() const { return ecritures; }
+
+private:
+    unsigned long ecritures = 0;
+};
 
 #endif
\ No newline at end of file
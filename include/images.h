@@ -2,11 +2,12 @@
 #define IMAGES_H
 
 #include <Arduino.h> // Nécessaire pour PROGMEM
+#include <PageBitmap.h>
 
 const int IMAGE_HEIGHT = 40;
 const int IMAGE_WIDTH = 60;
 
-const unsigned char IMAGE_CHAT[] PROGMEM = {
+constexpr unsigned char IMAGE_CHAT[] PROGMEM = {
     // 'silhouette-cute-cat-peeking-vector-600nw-2593333797, 60x40px
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
@@ -29,4 +30,7 @@ const unsigned char IMAGE_CHAT[] PROGMEM = {
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
 
+// Même image au format des pages du SSD1306, convertie à la compilation (OLEDDisplay::printImage)
+constexpr PageImage<IMAGE_WIDTH, IMAGE_HEIGHT> IMAGE_CHAT_PAGES PROGMEM = toPageImage<IMAGE_WIDTH, IMAGE_HEIGHT>(IMAGE_CHAT);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,242 @@
+/*
+ * BootTimeline.cpp
+ * Implémentation de la chronologie du démarrage
+ */
+
+#include "BootTimeline.h"
+#include <Preferences.h>
+
+#ifndef ESP8266
+#include <esp_system.h>
+#endif
+
+// Constructeur
+BootTimeline::BootTimeline(const char *firmware)
+{
+    this->firmware = firmware;
+    stepCount = 0;
+    resetReason = 0;
+    previousSlot = NO_SLOT;
+    saved = false;
+}
+
+void BootTimeline::begin()
+{
+#ifdef ESP8266
+    resetReason = ESP.getResetInfoPtr()->reason;
+#else
+    resetReason = (uint8_t)esp_reset_reason();
+#endif
+
+    Preferences preferences;
+    preferences.begin("boottimeline", true);
+    previousSlot = preferences.getUChar("slot", NO_SLOT);
+    preferences.end();
+
+    Serial.printf("[Boot] Reset : %s\n", resetReasonName(resetReason));
+}
+
+// Étapes
+int8_t BootTimeline::start(const char *name)
+{
+    const uint32_t now = micros();
+    if (stepCount >= MAX_STEPS)
+    {
+        Serial.println(F("[Boot] ✗ Chronologie pleine"));
+        return -1;
+    }
+    steps[stepCount].name = name;
+    steps[stepCount].startUs = now;
+    steps[stepCount].durationUs = OPEN_STEP;
+    return stepCount++;
+}
+
+void BootTimeline::end(int8_t step)
+{
+    const uint32_t now = micros();
+    if (step < 0 || step >= stepCount || steps[step].durationUs != OPEN_STEP)
+        return;
+
+    steps[step].durationUs = now - steps[step].startUs;
+    Serial.printf("[Boot] %s : %lu µs\n", steps[step].name, (unsigned long)steps[step].durationUs);
+}
+
+void BootTimeline::measure(const char *name, void (*function)())
+{
+    const int8_t step = start(name);
+    function();
+    end(step);
+}
+
+void BootTimeline::mark(const char *name)
+{
+    end(start(name));
+}
+
+// Persistance : emplacement libre (l'autre que le démarrage précédent), puis bascule
+void BootTimeline::save()
+{
+    if (saved)
+        return;
+
+    BootRecord *record = (BootRecord *)malloc(sizeof(BootRecord));
+    if (record == nullptr)
+    {
+        Serial.println(F("[Boot] ✗ Mémoire insuffisante pour l'enregistrement"));
+        return;
+    }
+    memset(record, 0, sizeof(BootRecord));
+    record->format = RECORD_FORMAT;
+    record->resetReason = resetReason;
+    record->count = stepCount;
+    strncpy(record->firmware, firmware, sizeof(record->firmware) - 1);
+    for (uint8_t i = 0; i < stepCount; i++)
+    {
+        strncpy(record->steps[i].name, steps[i].name, sizeof(record->steps[i].name) - 1);
+        record->steps[i].startUs = steps[i].startUs;
+        record->steps[i].durationUs = steps[i].durationUs;
+    }
+
+    const uint8_t slot = (previousSlot == 0) ? 1 : 0;
+    Preferences preferences;
+    preferences.begin("boottimeline", false);
+    preferences.putBytes(slotKey(slot), record, sizeof(BootRecord));
+    preferences.putUChar("slot", slot);
+    preferences.end();
+    free(record);
+
+    saved = true; // previousSlot reste celui du démarrage précédent
+    Serial.printf("[Boot] Chronologie enregistrée (%u étapes)\n", stepCount);
+}
+
+bool BootTimeline::isSaved() const
+{
+    return saved;
+}
+
+// Lecture
+uint8_t BootTimeline::getStepCount() const
+{
+    return stepCount;
+}
+
+const char *BootTimeline::getStepName(uint8_t index) const
+{
+    return index < stepCount ? steps[index].name : "";
+}
+
+uint32_t BootTimeline::getStepStartUs(uint8_t index) const
+{
+    return index < stepCount ? steps[index].startUs : 0;
+}
+
+uint32_t BootTimeline::getStepDurationUs(uint8_t index) const
+{
+    return index < stepCount ? steps[index].durationUs : OPEN_STEP;
+}
+
+uint8_t BootTimeline::getResetReason() const
+{
+    return resetReason;
+}
+
+bool BootTimeline::loadPrevious(BootRecord &record) const
+{
+    if (previousSlot == NO_SLOT)
+        return false;
+
+    Preferences preferences;
+    preferences.begin("boottimeline", true);
+    const size_t length = preferences.getBytes(slotKey(previousSlot), &record, sizeof(BootRecord));
+    preferences.end();
+
+    if (length != sizeof(BootRecord) || record.format != RECORD_FORMAT || record.count > MAX_STEPS)
+        return false; // Absent, tronqué ou d'un autre format
+    record.firmware[sizeof(record.firmware) - 1] = '\0';
+    for (uint8_t i = 0; i < record.count; i++)
+    {
+        record.steps[i].name[sizeof(record.steps[i].name) - 1] = '\0';
+    }
+    return true;
+}
+
+// JSON, écrit en flux. Le démarrage précédent est relu en flash le temps de la réponse
+void BootTimeline::writeJSON(Print &out) const
+{
+    out.print(F("{\"firmware\":\""));
+    out.print(firmware);
+    out.print(F("\",\"resetReason\":\""));
+    out.print(resetReasonName(resetReason));
+    out.print(F("\",\"saved\":"));
+    out.print(saved ? F("true") : F("false"));
+    out.print(F(",\"steps\":["));
+    for (uint8_t i = 0; i < stepCount; i++)
+    {
+        if (i > 0)
+            out.print(',');
+        writeStep(out, steps[i].name, steps[i].startUs, steps[i].durationUs);
+    }
+    out.print(F("],\"previous\":"));
+
+    BootRecord *record = (BootRecord *)malloc(sizeof(BootRecord));
+    if (record != nullptr && loadPrevious(*record))
+    {
+        out.print(F("{\"firmware\":\""));
+        out.print(record->firmware);
+        out.print(F("\",\"resetReason\":\""));
+        out.print(resetReasonName(record->resetReason));
+        out.print(F("\",\"steps\":["));
+        writeRecordSteps(out, *record);
+        out.print(F("]}"));
+    }
+    else
+    {
+        out.print(F("null"));
+    }
+    free(record);
+    out.print('}');
+}
+
+// Noms des raisons de reset du SDK
+const char *BootTimeline::resetReasonName(uint8_t reason)
+{
+#ifdef ESP8266
+    static const char *const names[] = {"power_on", "hw_wdt", "exception", "soft_wdt",
+                                        "soft_restart", "deep_sleep", "external"};
+#else
+    static const char *const names[] = {"unknown", "power_on", "external", "software", "panic",
+                                        "int_wdt", "task_wdt", "wdt", "deep_sleep", "brownout", "sdio"};
+#endif
+    return reason < sizeof(names) / sizeof(names[0]) ? names[reason] : "unknown";
+}
+
+// Méthodes privées
+void BootTimeline::writeRecordSteps(Print &out, const BootRecord &record)
+{
+    for (uint8_t i = 0; i < record.count; i++)
+    {
+        if (i > 0)
+            out.print(',');
+        writeStep(out, record.steps[i].name, record.steps[i].startUs, record.steps[i].durationUs);
+    }
+}
+
+// {"name":"setupScreen","startUs":123,"durationUs":456} ; durée null si l'étape est en cours
+void BootTimeline::writeStep(Print &out, const char *name, uint32_t startUs, uint32_t durationUs)
+{
+    out.print(F("{\"name\":\""));
+    out.print(name);
+    out.print(F("\",\"startUs\":"));
+    out.print((unsigned long)startUs);
+    out.print(F(",\"durationUs\":"));
+    if (durationUs == OPEN_STEP)
+        out.print(F("null"));
+    else
+        out.print((unsigned long)durationUs);
+    out.print('}');
+}
+
+const char *BootTimeline::slotKey(uint8_t slot)
+{
+    return slot == 0 ? "b0" : "b1";
+}
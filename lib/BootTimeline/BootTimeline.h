@@ -0,0 +1,94 @@
+/*
+ * BootTimeline.h
+ * Chronologie du démarrage, en microsecondes depuis la mise sous tension
+ * - Étapes nommées (début, durée) et événements ponctuels, y compris après setup()
+ * - Démarrage courant et précédent, avec la raison du reset et la version du firmware
+ * - Persistance en flash (Preferences) une seule fois par démarrage, sur deux emplacements
+ *   alternés : le démarrage précédent reste lisible pendant l'écriture du suivant
+ */
+
+#ifndef BOOT_TIMELINE_H
+#define BOOT_TIMELINE_H
+
+#include <Arduino.h>
+
+static const uint8_t BOOT_TIMELINE_MAX_STEPS = 16;
+
+// Étape enregistrée en flash
+struct BootStep
+{
+    char name[20];
+    uint32_t startUs;    // micros() au début de l'étape
+    uint32_t durationUs; // BootTimeline::OPEN_STEP si l'étape n'était pas terminée
+};
+
+// Démarrage complet, tel que persisté
+struct BootRecord
+{
+    uint16_t format; // Enregistrement d'un autre format : ignoré
+    uint8_t resetReason;
+    uint8_t count;
+    char firmware[24];
+    BootStep steps[BOOT_TIMELINE_MAX_STEPS];
+};
+
+class BootTimeline
+{
+public:
+    static const uint8_t MAX_STEPS = BOOT_TIMELINE_MAX_STEPS;
+    static const uint32_t OPEN_STEP = 0xFFFFFFFF;
+
+    // Constructeur : firmware identifie la version (ex: __DATE__ " " __TIME__)
+    BootTimeline(const char *firmware);
+
+    // À appeler au tout début de setup() : raison du reset, emplacement du démarrage précédent
+    void begin();
+
+    // Étapes : le nom n'est pas copié avant save(), il doit rester valide (littéral)
+    int8_t start(const char *name);            // Identifiant de l'étape, -1 si la liste est pleine
+    void end(int8_t step);                     // Sans effet pour -1 ou une étape déjà terminée
+    void measure(const char *name, void (*function)()); // start() + appel + end()
+    void mark(const char *name);               // Événement ponctuel (durée nulle)
+
+    // Persistance du démarrage courant : une fois, quand les étapes différées sont terminées
+    void save();
+    bool isSaved() const;
+
+    // Lecture
+    uint8_t getStepCount() const;
+    const char *getStepName(uint8_t index) const;
+    uint32_t getStepStartUs(uint8_t index) const;
+    uint32_t getStepDurationUs(uint8_t index) const; // OPEN_STEP si en cours
+    uint8_t getResetReason() const;
+    bool loadPrevious(BootRecord &record) const; // false si aucun démarrage précédent enregistré
+
+    // JSON : {"firmware":..,"resetReason":..,"saved":..,"steps":[..],"previous":{..}|null}
+    void writeJSON(Print &out) const;
+
+    static const char *resetReasonName(uint8_t reason);
+
+private:
+    static const uint16_t RECORD_FORMAT = 1;
+    static const uint8_t NO_SLOT = 0xFF;
+
+    struct Step
+    {
+        const char *name;
+        uint32_t startUs;
+        uint32_t durationUs;
+    };
+
+    const char *firmware;
+    Step steps[MAX_STEPS];
+    uint8_t stepCount;
+    uint8_t resetReason;
+    uint8_t previousSlot; // Emplacement du dernier démarrage enregistré (NO_SLOT : aucun)
+    bool saved;
+
+    // Méthodes privées
+    static void writeRecordSteps(Print &out, const BootRecord &record);
+    static void writeStep(Print &out, const char *name, uint32_t startUs, uint32_t durationUs);
+    static const char *slotKey(uint8_t slot);
+};
+
+#endif // BOOT_TIMELINE_H
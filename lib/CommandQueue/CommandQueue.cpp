@@ -0,0 +1,219 @@
+/*
+ * CommandQueue.cpp
+ * Implémentation de la file de commandes
+ */
+
+#include "CommandQueue.h"
+
+// Constructeur
+CommandQueue::CommandQueue(unsigned long coalesceMs)
+{
+    this->coalesceMs = coalesceMs;
+    nextId = 1;
+    executeCallback = nullptr;
+    completeCallback = nullptr;
+
+    enqueuedCount = 0;
+    coalescedCount = 0;
+    overflowCount = 0;
+
+    for (uint8_t i = 0; i < MAX_COMMANDS; i++)
+    {
+        commands[i].id = 0;
+    }
+}
+
+void CommandQueue::onExecute(ExecuteCallback callback)
+{
+    executeCallback = callback;
+}
+
+void CommandQueue::onComplete(CompleteCallback callback)
+{
+    completeCallback = callback;
+}
+
+// Dépôt d'une commande
+uint32_t CommandQueue::enqueue(uint8_t type, int32_t arg, uint8_t source)
+{
+    Command *original = findDuplicate(type, arg);
+    Command *command = allocate(original); // L'original reste consultable
+    if (command == nullptr)
+    {
+        overflowCount++;
+        Serial.println(F("[Commandes] File pleine, commande refusée"));
+        return 0;
+    }
+
+    command->id = nextId++;
+    if (nextId == 0)
+    {
+        nextId = 1; // 0 est réservé aux emplacements libres
+    }
+    command->type = type;
+    command->arg = arg;
+    command->source = source;
+    command->result = 0;
+    command->coalescedInto = 0;
+    command->enqueuedAt = millis();
+    command->finishedAt = 0;
+
+    if (original != nullptr)
+    {
+        // Doublon : refusé tout de suite, le résultat est celui de la commande d'origine
+        command->state = COMMAND_COALESCED;
+        command->coalescedInto = original->id;
+        coalescedCount++;
+        finish(*command);
+    }
+    else
+    {
+        command->state = COMMAND_PENDING;
+        enqueuedCount++;
+    }
+    return command->id;
+}
+
+// Exécution de la plus ancienne commande en attente
+bool CommandQueue::process()
+{
+    Command *next = nullptr;
+    for (uint8_t i = 0; i < MAX_COMMANDS; i++)
+    {
+        if (commands[i].id != 0 && commands[i].state == COMMAND_PENDING &&
+            (next == nullptr || (int32_t)(commands[i].id - next->id) < 0))
+        {
+            next = &commands[i];
+        }
+    }
+    if (next == nullptr)
+    {
+        return false;
+    }
+
+    next->state = COMMAND_RUNNING;
+    next->result = executeCallback ? executeCallback(*next) : 0;
+    next->state = COMMAND_DONE;
+    finish(*next);
+    return true;
+}
+
+// Suivi
+const Command *CommandQueue::find(uint32_t id) const
+{
+    if (id == 0)
+    {
+        return nullptr;
+    }
+    for (uint8_t i = 0; i < MAX_COMMANDS; i++)
+    {
+        if (commands[i].id == id)
+        {
+            return &commands[i];
+        }
+    }
+    return nullptr;
+}
+
+CommandState CommandQueue::getState(uint32_t id) const
+{
+    const Command *command = find(id);
+    return command != nullptr ? command->state : COMMAND_UNKNOWN;
+}
+
+uint8_t CommandQueue::getPendingCount() const
+{
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < MAX_COMMANDS; i++)
+    {
+        if (commands[i].id != 0 && commands[i].state == COMMAND_PENDING)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+// Statistiques
+uint32_t CommandQueue::getEnqueuedCount() const
+{
+    return enqueuedCount;
+}
+
+uint32_t CommandQueue::getCoalescedCount() const
+{
+    return coalescedCount;
+}
+
+uint32_t CommandQueue::getOverflowCount() const
+{
+    return overflowCount;
+}
+
+const char *CommandQueue::stateName(CommandState state)
+{
+    switch (state)
+    {
+    case COMMAND_PENDING:
+        return "pending";
+    case COMMAND_RUNNING:
+        return "running";
+    case COMMAND_DONE:
+        return "done";
+    case COMMAND_COALESCED:
+        return "coalesced";
+    default:
+        return "unknown";
+    }
+}
+
+// Méthodes privées
+
+// Commande identique en attente, en cours, ou terminée depuis moins de coalesceMs
+Command *CommandQueue::findDuplicate(uint8_t type, int32_t arg)
+{
+    const unsigned long now = millis();
+    for (uint8_t i = 0; i < MAX_COMMANDS; i++)
+    {
+        Command &command = commands[i];
+        if (command.id == 0 || command.type != type || command.arg != arg)
+        {
+            continue;
+        }
+        if (command.state == COMMAND_PENDING || command.state == COMMAND_RUNNING ||
+            (command.state == COMMAND_DONE && now - command.finishedAt < coalesceMs))
+        {
+            return &command;
+        }
+    }
+    return nullptr;
+}
+
+// Emplacement libre, sinon la plus ancienne commande terminée (hors keep)
+Command *CommandQueue::allocate(const Command *keep)
+{
+    Command *oldest = nullptr;
+    for (uint8_t i = 0; i < MAX_COMMANDS; i++)
+    {
+        Command &command = commands[i];
+        if (command.id == 0)
+        {
+            return &command;
+        }
+        if (&command != keep && (command.state == COMMAND_DONE || command.state == COMMAND_COALESCED) &&
+            (oldest == nullptr || (int32_t)(command.id - oldest->id) < 0))
+        {
+            oldest = &command;
+        }
+    }
+    return oldest;
+}
+
+void CommandQueue::finish(Command &command)
+{
+    command.finishedAt = millis();
+    if (completeCallback)
+    {
+        completeCallback(command);
+    }
+}
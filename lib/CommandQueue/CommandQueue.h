@@ -0,0 +1,93 @@
+/*
+ * CommandQueue.h
+ * File de commandes bornée : les déclencheurs (web, bouton, automatique) déposent
+ * une commande, un seul exécutant la traite dans loop()
+ * - Taille fixe, aucune allocation
+ * - Regroupement : une commande identique (même type, même argument) déjà en attente
+ *   ou exécutée depuis moins de coalesceMs est refusée et renvoie vers la première
+ * - Suivi : chaque commande a un identifiant, son état et son résultat restent
+ *   consultables tant que son emplacement n'est pas réutilisé
+ */
+
+#ifndef COMMAND_QUEUE_H
+#define COMMAND_QUEUE_H
+
+#include <Arduino.h>
+#include <functional>
+
+enum CommandState
+{
+    COMMAND_PENDING,   // En attente d'exécution
+    COMMAND_RUNNING,   // En cours d'exécution
+    COMMAND_DONE,      // Exécutée, résultat disponible
+    COMMAND_COALESCED, // Refusée : doublon d'une commande récente (voir coalescedInto)
+    COMMAND_UNKNOWN    // Identifiant inconnu ou emplacement déjà réutilisé
+};
+
+struct Command
+{
+    uint32_t id; // 0 : emplacement libre
+    uint8_t type;
+    int32_t arg;
+    uint8_t source;
+    CommandState state;
+    int16_t result;         // Valeur renvoyée par l'exécutant (COMMAND_DONE)
+    uint32_t coalescedInto; // Commande qui a absorbé ce doublon (COMMAND_COALESCED)
+    unsigned long enqueuedAt;
+    unsigned long finishedAt;
+};
+
+class CommandQueue
+{
+public:
+    typedef std::function<int16_t(const Command &)> ExecuteCallback;
+    typedef std::function<void(const Command &)> CompleteCallback;
+
+    static const uint8_t MAX_COMMANDS = 8; // En attente + dernières terminées
+
+    // Constructeur
+    CommandQueue(unsigned long coalesceMs = 2000);
+
+    // Exécutant unique et notification de fin (ex: événement SSE)
+    void onExecute(ExecuteCallback callback);
+    void onComplete(CompleteCallback callback);
+
+    // Dépôt d'une commande : renvoie son identifiant, 0 si la file est pleine
+    // Un doublon reçoit aussi un identifiant, avec l'état COMMAND_COALESCED
+    uint32_t enqueue(uint8_t type, int32_t arg, uint8_t source);
+
+    // À appeler dans loop() : exécute au plus une commande par appel
+    // Renvoie true si une commande a été exécutée
+    bool process();
+
+    // Suivi
+    const Command *find(uint32_t id) const; // nullptr si inconnu
+    CommandState getState(uint32_t id) const;
+    uint8_t getPendingCount() const;
+
+    // Statistiques
+    uint32_t getEnqueuedCount() const;
+    uint32_t getCoalescedCount() const;
+    uint32_t getOverflowCount() const;
+
+    static const char *stateName(CommandState state);
+
+private:
+    Command commands[MAX_COMMANDS];
+    uint32_t nextId;
+    unsigned long coalesceMs;
+    ExecuteCallback executeCallback;
+    CompleteCallback completeCallback;
+
+    // Statistiques
+    uint32_t enqueuedCount;
+    uint32_t coalescedCount;
+    uint32_t overflowCount;
+
+    // Méthodes privées
+    Command *findDuplicate(uint8_t type, int32_t arg);
+    Command *allocate(const Command *keep);
+    void finish(Command &command);
+};
+
+#endif // COMMAND_QUEUE_H
@@ -0,0 +1,273 @@
+/*
+ * Metrics.cpp
+ * Implémentation des mesures et de l'écriture au format Prometheus
+ */
+
+#include "Metrics.h"
+
+// -------------------- LatencyHistogram --------------------
+LatencyHistogram::LatencyHistogram()
+{
+    reset();
+}
+
+void LatencyHistogram::record(uint32_t us)
+{
+    uint8_t i = 0;
+    while (i < BUCKET_COUNT - 1 && us >= getBucketUpperUs(i))
+    {
+        i++;
+    }
+    buckets[i]++;
+    count++;
+    sumUs += us;
+    if (us > maxUs)
+    {
+        maxUs = us;
+    }
+}
+
+void LatencyHistogram::reset()
+{
+    for (uint8_t i = 0; i < BUCKET_COUNT; i++)
+    {
+        buckets[i] = 0;
+    }
+    count = 0;
+    sumUs = 0;
+    maxUs = 0;
+}
+
+uint32_t LatencyHistogram::getCount() const
+{
+    return count;
+}
+
+uint64_t LatencyHistogram::getSumUs() const
+{
+    return sumUs;
+}
+
+uint32_t LatencyHistogram::getMaxUs() const
+{
+    return maxUs;
+}
+
+uint32_t LatencyHistogram::getBucket(uint8_t i) const
+{
+    return i < BUCKET_COUNT ? buckets[i] : 0;
+}
+
+uint32_t LatencyHistogram::getBucketUpperUs(uint8_t i)
+{
+    return 1UL << i; // Seau 0 : [0, 1[, seau 1 : [1, 2[, seau 2 : [2, 4[...
+}
+
+uint32_t LatencyHistogram::percentileUs(float q) const
+{
+    if (count == 0)
+    {
+        return 0;
+    }
+    const float rang = q * count;
+    uint32_t cumul = 0;
+    for (uint8_t i = 0; i < BUCKET_COUNT; i++)
+    {
+        if (buckets[i] == 0)
+        {
+            continue;
+        }
+        if (cumul + buckets[i] >= rang)
+        {
+            const uint32_t basse = (i == 0) ? 0 : getBucketUpperUs(i - 1);
+            uint32_t haute = (i == BUCKET_COUNT - 1) ? maxUs : getBucketUpperUs(i);
+            if (haute > maxUs)
+            {
+                haute = maxUs; // Jamais au-delà de la valeur maximale observée
+            }
+            if (haute < basse)
+            {
+                return basse;
+            }
+            const float fraction = (rang - cumul) / buckets[i];
+            // Arrondi du float borné : sans quoi basse + écart peut dépasser haute (et déborder près de 2^32)
+            const uint32_t ecart = (uint32_t)(fraction * (haute - basse));
+            return basse + (ecart < haute - basse ? ecart : haute - basse);
+        }
+        cumul += buckets[i];
+    }
+    return maxUs;
+}
+
+// -------------------- PrometheusWriter --------------------
+PrometheusWriter::PrometheusWriter(Print &out) : out(out)
+{
+    labelsOpen = false;
+    bytesWritten = 0;
+}
+
+void PrometheusWriter::family(const char *name, const char *type, const char *help)
+{
+    bytesWritten += out.print(F("# HELP "));
+    bytesWritten += out.print(name);
+    bytesWritten += out.print(' ');
+    printEscaped(help, true);
+    bytesWritten += out.print(F("\n# TYPE "));
+    bytesWritten += out.print(name);
+    bytesWritten += out.print(' ');
+    bytesWritten += out.print(type);
+    bytesWritten += out.print('\n');
+}
+
+PrometheusWriter &PrometheusWriter::sample(const char *name, const char *suffix)
+{
+    bytesWritten += out.print(name);
+    if (suffix != nullptr)
+    {
+        bytesWritten += out.print(suffix);
+    }
+    labelsOpen = false;
+    return *this;
+}
+
+PrometheusWriter &PrometheusWriter::label(const char *name, const char *value)
+{
+    bytesWritten += out.print(labelsOpen ? ',' : '{');
+    labelsOpen = true;
+    bytesWritten += out.print(name);
+    bytesWritten += out.print(F("=\""));
+    printEscaped(value, false);
+    bytesWritten += out.print('"');
+    return *this;
+}
+
+PrometheusWriter &PrometheusWriter::label(const char *name, long value)
+{
+    char texte[12];
+    snprintf(texte, sizeof(texte), "%ld", value);
+    return label(name, texte);
+}
+
+void PrometheusWriter::value(unsigned long v)
+{
+    beginValue();
+    bytesWritten += out.print(v);
+    bytesWritten += out.print('\n');
+}
+
+void PrometheusWriter::value(long v)
+{
+    beginValue();
+    bytesWritten += out.print(v);
+    bytesWritten += out.print('\n');
+}
+
+void PrometheusWriter::value(int v)
+{
+    value((long)v);
+}
+
+void PrometheusWriter::value(unsigned long long v)
+{
+    // Conversion manuelle : Print n'a pas de surcharge 64 bits sur tous les cores
+    char texte[21];
+    uint8_t i = sizeof(texte) - 1;
+    texte[i] = '\0';
+    do
+    {
+        texte[--i] = '0' + (v % 10);
+        v /= 10;
+    } while (v > 0 && i > 0);
+
+    beginValue();
+    bytesWritten += out.print(texte + i);
+    bytesWritten += out.print('\n');
+}
+
+void PrometheusWriter::value(float v, uint8_t decimals)
+{
+    beginValue();
+    if (isnan(v))
+    {
+        bytesWritten += out.print(F("NaN"));
+    }
+    else
+    {
+        bytesWritten += out.print(v, decimals);
+    }
+    bytesWritten += out.print('\n');
+}
+
+void PrometheusWriter::gauge(const char *name, const char *help, float v, uint8_t decimals)
+{
+    family(name, "gauge", help);
+    sample(name).value(v, decimals);
+}
+
+void PrometheusWriter::gauge(const char *name, const char *help, long v)
+{
+    family(name, "gauge", help);
+    sample(name).value(v);
+}
+
+void PrometheusWriter::counter(const char *name, const char *help, unsigned long v)
+{
+    family(name, "counter", help);
+    sample(name).value(v);
+}
+
+void PrometheusWriter::summary(const char *name, const char *help, const LatencyHistogram &histogram)
+{
+    static const char *const quantiles[] = {"0.5", "0.9", "0.99"};
+    static const float valeurs[] = {0.5f, 0.9f, 0.99f};
+
+    family(name, "summary", help);
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        sample(name).label("quantile", quantiles[i]).value(histogram.percentileUs(valeurs[i]) / 1e6f);
+    }
+    sample(name, "_sum").value((float)(histogram.getSumUs() / 1e6), 3);
+    sample(name, "_count").value((unsigned long)histogram.getCount());
+}
+
+size_t PrometheusWriter::getBytesWritten() const
+{
+    return bytesWritten;
+}
+
+// Méthodes privées
+void PrometheusWriter::beginValue()
+{
+    if (labelsOpen)
+    {
+        bytesWritten += out.print('}');
+        labelsOpen = false;
+    }
+    bytesWritten += out.print(' ');
+}
+
+// Échappement du format texte : \\ et \n partout, \" en plus dans les valeurs de labels
+void PrometheusWriter::printEscaped(const char *text, bool help)
+{
+    if (text == nullptr)
+        return;
+
+    for (const char *p = text; *p != '\0'; p++)
+    {
+        switch (*p)
+        {
+        case '\\':
+            bytesWritten += out.print(F("\\\\"));
+            break;
+        case '\n':
+            bytesWritten += out.print(F("\\n"));
+            break;
+        case '"':
+            bytesWritten += help ? out.print('"') : out.print(F("\\\""));
+            break;
+        default:
+            bytesWritten += out.print(*p);
+            break;
+        }
+    }
+}
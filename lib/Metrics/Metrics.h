@@ -0,0 +1,83 @@
+/*
+ * Metrics.h
+ * Mesures exposées au format texte Prometheus (/metrics)
+ * - LatencyHistogram : histogramme de durées à seaux puissances de 2 (taille fixe)
+ * - PrometheusWriter : écriture en flux des familles et échantillons sur n'importe quel Print
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <Arduino.h>
+
+// Histogramme de latences en microsecondes
+// Seau i : durées dans [2^(i-1), 2^i[ µs (seau 0 : 0 µs), le dernier seau collecte tout le reste
+class LatencyHistogram
+{
+public:
+    static const uint8_t BUCKET_COUNT = 24; // Jusqu'à ~8 s
+
+    LatencyHistogram();
+
+    void record(uint32_t us);
+    void reset();
+
+    uint32_t getCount() const;
+    uint64_t getSumUs() const;
+    uint32_t getMaxUs() const;
+    uint32_t getBucket(uint8_t i) const;
+    static uint32_t getBucketUpperUs(uint8_t i); // Borne haute (exclue) du seau
+
+    // Percentile estimé (interpolation linéaire dans le seau), q dans [0, 1]
+    uint32_t percentileUs(float q) const;
+
+private:
+    uint32_t buckets[BUCKET_COUNT];
+    uint32_t count;
+    uint64_t sumUs;
+    uint32_t maxUs;
+};
+
+// Écriture au format d'exposition texte Prometheus 0.0.4
+// Aucune allocation : tout est écrit directement dans le Print (ex: ResponseWriter)
+//   PrometheusWriter prom(out);
+//   prom.family("app_requests_total", "counter", "Requêtes HTTP");
+//   prom.sample("app_requests_total").label("route", "/api/data").value(12UL);
+class PrometheusWriter
+{
+public:
+    PrometheusWriter(Print &out);
+
+    // En-têtes # HELP / # TYPE (type : counter, gauge, summary, histogram, untyped)
+    void family(const char *name, const char *type, const char *help);
+
+    // Échantillon : sample() puis label() (optionnels) puis value()
+    PrometheusWriter &sample(const char *name, const char *suffix = nullptr); // suffix : "_sum", "_count"...
+    PrometheusWriter &label(const char *name, const char *value);
+    PrometheusWriter &label(const char *name, long value);
+    void value(unsigned long v);
+    void value(long v);
+    void value(unsigned long long v);
+    void value(int v);
+    void value(float v, uint8_t decimals = 6);
+
+    // Raccourcis sans label
+    void gauge(const char *name, const char *help, float v, uint8_t decimals = 6);
+    void gauge(const char *name, const char *help, long v);
+    void counter(const char *name, const char *help, unsigned long v);
+
+    // Résumé (quantiles 0.5, 0.9, 0.99 + _sum + _count) en secondes
+    void summary(const char *name, const char *help, const LatencyHistogram &histogram);
+
+    size_t getBytesWritten() const;
+
+private:
+    Print &out;
+    bool labelsOpen;
+    size_t bytesWritten;
+
+    void beginValue();
+    void printEscaped(const char *text, bool help);
+};
+
+#endif // METRICS_H
@@ -0,0 +1,30 @@
+/*
+ * GlyphFont.h
+ * Police 5x7 intégrée, au format des pages du SSD1306 (une colonne de 8 pixels par octet,
+ * bit 0 en haut), identique à la police par défaut d'Adafruit_GFX pour l'ASCII
+ * - Largeurs connues à la compilation : mesurer un texte ne demande qu'un passage
+ * - Texte UTF-8 : les lettres accentuées du français ont leur glyphe, les autres
+ *   caractères non ASCII s'affichent '?'
+ */
+
+#ifndef GLYPH_FONT_H
+#define GLYPH_FONT_H
+
+#include <Arduino.h>
+
+static const uint8_t GLYPH_COLUMNS = 5; // Colonnes dessinées par caractère
+static const uint8_t GLYPH_ADVANCE = 6; // Avec la colonne d'espacement (comme Adafruit_GFX)
+static const uint8_t GLYPH_HEIGHT = 8;  // Une page, espacement et jambages compris
+
+// Avance d'un octet de texte UTF-8, en colonnes (taille 1) : un glyphe par caractère ASCII
+// imprimable ou par début de séquence, rien pour les octets de suite et les caractères de contrôle
+constexpr uint8_t glyphAdvance(uint8_t c)
+{
+    return ((c >= 0x20 && c < 0x7F) || c >= 0xC0) ? GLYPH_ADVANCE : 0;
+}
+
+// Glyphe du caractère en tête de text (avance text après le caractère) :
+// GLYPH_COLUMNS octets en PROGMEM, nullptr si le caractère ne se dessine pas
+const uint8_t *glyphColumns(const char *&text);
+
+#endif // GLYPH_FONT_H
@@ -18,6 +18,35 @@ OLEDDisplay::OLEDDisplay(uint8_t width, uint8_t height, uint8_t address)
     displayDuration = 0;
     autoRefresh = true;
     isDisplaying = false;
+    updateCallback = nullptr;
+    textInverted = false;
+    frameCallback = nullptr;
+
+    txBuffer = nullptr;
+    sendPage = NO_PAGE;
+    sendColumn = 0;
+    sendEnd = 0;
+    asyncFlush = false;
+    i2cClock = 400000;
+    flushBudgetUs = 2000;
+
+    flushCount = 0;
+    flushBytesTotal = 0;
+    lastFlushBytes = 0;
+    lastFlushUs = 0;
+    maxFlushUs = 0;
+    txBytes = 0;
+    txUs = 0;
+    maxPumpUs = 0;
+    for (uint8_t page = 0; page < MAX_PAGES; page++)
+    {
+        dirtyMin[page] = 0xFF; // Page propre
+        dirtyMax[page] = 0;
+        memset(pendingMask[page], 0, sizeof(pendingMask[page]));
+    }
+    forceSend = false;
+    comparedBytes = 0;
+    skippedBytes = 0;
 }
 
 // Initialisation
@@ -27,9 +56,19 @@ bool OLEDDisplay::begin(int8_t resetPin)
     {
         return false;
     }
+    if (txBuffer == nullptr)
+    {
+        txBuffer = (uint8_t *)malloc(screenWidth * (screenHeight / 8));
+        if (txBuffer == nullptr)
+        {
+            return false;
+        }
+    }
     display->clearDisplay();
     display->setTextColor(WHITE);
-    display->display();
+    display->display(); // Écran complet une fois : la suite ne renvoie que les zones modifiées
+    memset(txBuffer, 0, screenWidth * (screenHeight / 8));
+    Wire.setClock(i2cClock);
     return true;
 }
 
@@ -45,6 +84,26 @@ void OLEDDisplay::setBrightness(uint8_t brightness)
     display->ssd1306_command(brightness);
 }
 
+void OLEDDisplay::setI2CClock(uint32_t hz)
+{
+    i2cClock = hz;
+    Wire.setClock(hz);
+}
+
+void OLEDDisplay::setAsyncFlush(bool enabled)
+{
+    asyncFlush = enabled;
+    if (!enabled)
+    {
+        waitFlush();
+    }
+}
+
+void OLEDDisplay::setFlushBudget(unsigned long us)
+{
+    flushBudgetUs = us;
+}
+
 // Gestion du timer
 void OLEDDisplay::startTimer(unsigned int seconds)
 {
@@ -64,36 +123,73 @@ bool OLEDDisplay::isTimerActive()
     return isDisplaying && (millis() - displayTimerStart < displayDuration);
 }
 
+// Fin du timer, puis un seul envoi pour tous les dessins de la boucle
 void OLEDDisplay::update()
 {
+    if (updateCallback)
+    {
+        updateCallback();
+    }
+
     if (isDisplaying && (millis() - displayTimerStart >= displayDuration))
     {
         clear();
-        display->display();
+        flush();
         isDisplaying = false;
     }
+    if (autoRefresh)
+    {
+        flush(); // Sans effet si rien n'a changé
+    }
+
+    // Envoi par morceaux : au plus flushBudgetUs par passage dans loop()
+    if (isFlushing())
+    {
+        const unsigned long start = micros();
+        pump(flushBudgetUs);
+        const uint32_t elapsed = micros() - start;
+        if (elapsed > maxPumpUs)
+        {
+            maxPumpUs = elapsed;
+        }
+    }
+}
+
+void OLEDDisplay::setUpdateCallback(std::function<void()> callback)
+{
+    updateCallback = callback;
 }
 
 // Effacement
 void OLEDDisplay::clear()
 {
     display->clearDisplay();
+    markDirty(0, 0, screenWidth, screenHeight); // Seul ce qui était allumé sera envoyé
 }
 
 void OLEDDisplay::clearAndDisplay()
 {
-    display->clearDisplay();
-    display->display();
+    clear();
+    flush();
 }
 
-// Affichage de texte simple
+// Affichage de texte simple : une ligne par '\n', les suivantes repartent de x = 0
 void OLEDDisplay::printText(const char *text, uint8_t x, uint8_t y, uint8_t size)
 {
-    display->setTextSize(size);
-    display->setCursor(x, y);
-    display->print(text);
-    if (autoRefresh)
-        display->display();
+    int16_t lineX = x;
+    int16_t lineY = y;
+    const char *line = text;
+    while (true)
+    {
+        const char *end = strchr(line, '\n');
+        const size_t length = (end != nullptr) ? (size_t)(end - line) : strlen(line);
+        drawGlyphs(line, length, lineX, lineY, size);
+        if (end == nullptr)
+            break;
+        line = end + 1;
+        lineX = 0;
+        lineY += GLYPH_HEIGHT * size;
+    }
 }
 
 void OLEDDisplay::printText(String text, uint8_t x, uint8_t y, uint8_t size)
@@ -101,13 +197,16 @@ void OLEDDisplay::printText(String text, uint8_t x, uint8_t y, uint8_t size)
     printText(text.c_str(), x, y, size);
 }
 
+// Largeur d'un texte : somme des avances, sans dessiner
+uint16_t OLEDDisplay::getTextWidth(const char *text, uint8_t size) const
+{
+    return textWidth(text, strlen(text), size);
+}
+
 // Calcul de position alignée X
 int16_t OLEDDisplay::getAlignedX(const char *text, TextAlign align, uint8_t textSize)
 {
-    int16_t x1, y1;
-    uint16_t w, h;
-    display->setTextSize(textSize);
-    display->getTextBounds(text, 0, 0, &x1, &y1, &w, &h);
+    const int16_t w = getTextWidth(text, textSize);
 
     switch (align)
     {
@@ -127,11 +226,16 @@ int16_t OLEDDisplay::getAlignedX(String text, TextAlign align, uint8_t textSize)
     return getAlignedX(text.c_str(), align, textSize);
 }
 
-// Affichage de texte aligné
+// Affichage de texte aligné : coupé aux espaces s'il ne tient pas sur une ligne
 void OLEDDisplay::printTextAligned(const char *text, TextAlign align, uint8_t y, uint8_t size)
 {
-    int16_t x = getAlignedX(text, align, size);
-    printText(text, x, y, size);
+    const size_t length = strlen(text);
+    if (textWidth(text, length, size) > screenWidth || strchr(text, '\n') != nullptr)
+    {
+        wrapText(text, size, screenWidth, align, y);
+        return;
+    }
+    drawGlyphs(text, length, getAlignedX(text, align, size), y, size);
 }
 
 void OLEDDisplay::printTextAligned(String text, TextAlign align, uint8_t y, uint8_t size)
@@ -139,18 +243,12 @@ void OLEDDisplay::printTextAligned(String text, TextAlign align, uint8_t y, uint
     printTextAligned(text.c_str(), align, y, size);
 }
 
-// Affichage de texte centré
+// Affichage de texte centré (le bloc de lignes si le texte est coupé)
 void OLEDDisplay::printTextCentered(const char *text, uint8_t size)
 {
-    int16_t x1, y1;
-    uint16_t w, h;
-    display->setTextSize(size);
-    display->getTextBounds(text, 0, 0, &x1, &y1, &w, &h);
-
-    int16_t x = (screenWidth - w) / 2;
-    int16_t y = (screenHeight - h) / 2;
-
-    printText(text, x, y, size);
+    const uint8_t lines = wrapText(text, size, screenWidth, ALIGN_CENTER, 0, false);
+    const int16_t y = (screenHeight - lines * GLYPH_HEIGHT * size) / 2;
+    wrapText(text, size, screenWidth, ALIGN_CENTER, y < 0 ? 0 : y);
 }
 
 void OLEDDisplay::printTextCentered(String text, uint8_t size)
@@ -160,14 +258,29 @@ void OLEDDisplay::printTextCentered(String text, uint8_t size)
 
 // Affichage de message avec titre
 void OLEDDisplay::printMessage(const char *title, const char *message, unsigned int displayTimeSec)
+{
+    drawMessage(title, message);
+    flush();
+    startTimer(displayTimeSec);
+}
+
+// Composition seule : titre (en négatif si inverted), puis message coupé aux espaces
+void OLEDDisplay::drawMessage(const char *title, const char *message, bool inverted)
 {
     clear();
 
-    printTextAligned(title, ALIGN_CENTER, 0, 2);
+    if (inverted)
+    {
+        display->fillRect(0, 0, screenWidth, 16, WHITE);
+        textInverted = true;
+        printTextAligned(title, ALIGN_CENTER, 0, 2);
+        textInverted = false;
+    }
+    else
+    {
+        printTextAligned(title, ALIGN_CENTER, 0, 2);
+    }
     printTextAligned(message, ALIGN_CENTER, 20, 1);
-
-    display->display();
-    startTimer(displayTimeSec);
 }
 
 void OLEDDisplay::printMessage(String title, String message, unsigned int displayTimeSec)
@@ -179,10 +292,8 @@ void OLEDDisplay::printMessage(String title, String message, unsigned int displa
 void OLEDDisplay::printLongText(const char *text, uint8_t size, unsigned int displayTimeSec)
 {
     clear();
-    display->setTextSize(size);
-    display->setCursor(0, 0);
-    display->print(text);
-    display->display();
+    wrapText(text, size, screenWidth, ALIGN_LEFT, 0);
+    flush(); // clear() a déjà marqué tout l'écran
     startTimer(displayTimeSec);
 }
 
@@ -195,10 +306,8 @@ void OLEDDisplay::printLongText(String text, uint8_t size, unsigned int displayT
 void OLEDDisplay::printImage(const uint8_t *bitmap, uint8_t width, uint8_t height,
                              uint8_t x, uint8_t y)
 {
-
     display->drawBitmap(x, y, bitmap, width, height, WHITE);
-    if (autoRefresh)
-        display->display();
+    markDirty(x, y, width, height);
 }
 
 void OLEDDisplay::printImageCentered(const uint8_t *bitmap, uint8_t width, uint8_t height)
@@ -207,6 +316,52 @@ void OLEDDisplay::printImageCentered(const uint8_t *bitmap, uint8_t width, uint8
     uint8_t x = (screenWidth - width) / 2;
     uint8_t y = (screenHeight - height) / 2;
     printImage(bitmap, width, height, x, y);
+    flush();
+}
+
+// Image au format des pages : chaque octet source couvre 8 lignes d'une colonne.
+// Y aligné sur 8 : un OU par octet ; sinon l'octet est décalé sur deux pages
+void OLEDDisplay::printImage(const PageBitmap &image, uint8_t x, uint8_t y)
+{
+    uint8_t *buffer = display->getBuffer();
+    const uint8_t screenPages = screenHeight / 8;
+    const uint8_t imagePages = (image.height + 7) / 8;
+    const uint8_t shift = y & 7;
+    const uint8_t width = (x + image.width > screenWidth) ? screenWidth - x : image.width;
+    if (x >= screenWidth || y >= screenHeight)
+        return;
+
+    for (uint8_t page = 0; page < imagePages; page++)
+    {
+        const uint8_t target = (y >> 3) + page;
+        if (target >= screenPages)
+            break;
+
+        // Lignes au-delà de la hauteur de l'image : ignorées (dernière page incomplète)
+        const uint8_t rows = image.height - page * 8;
+        const uint8_t mask = rows >= 8 ? 0xFF : (uint8_t)((1 << rows) - 1);
+        const uint8_t *source = image.data + page * image.width;
+        uint8_t *line = buffer + target * screenWidth + x;
+        uint8_t *next = (shift != 0 && target + 1 < screenPages) ? line + screenWidth : nullptr;
+
+        for (uint8_t column = 0; column < width; column++)
+        {
+            const uint8_t bits = pgm_read_byte(source + column) & mask;
+            line[column] |= bits << shift;
+            if (next != nullptr)
+            {
+                next[column] |= bits >> (8 - shift);
+            }
+        }
+    }
+    markDirty(x, y, width, image.height);
+}
+
+void OLEDDisplay::printImageCentered(const PageBitmap &image)
+{
+    clear();
+    printImage(image, (screenWidth - image.width) / 2, (screenHeight - image.height) / 2);
+    flush();
 }
 
 // Barre de progression
@@ -231,26 +386,20 @@ void OLEDDisplay::drawProgressBar(uint8_t x, uint8_t y, uint8_t width, uint8_t h
     if (showPercentage)
     {
         char buffer[5];
-        sprintf(buffer, "%d%%", progress);
-
-        int16_t x1, y1;
-        uint16_t w, h;
-        display->setTextSize(1);
-        display->getTextBounds(buffer, 0, 0, &x1, &y1, &w, &h);
+        const uint8_t length = sprintf(buffer, "%d%%", progress);
 
         // Centrer le texte sur la barre
+        const uint16_t w = textWidth(buffer, length, 1);
         uint8_t textX = x + (width - w) / 2;
-        uint8_t textY = y + (height - h) / 2;
+        uint8_t textY = y + (height - GLYPH_HEIGHT) / 2;
 
         // Inverser la couleur du texte pour qu'il soit visible
-        display->setTextColor(BLACK, WHITE);
-        display->setCursor(textX, textY);
-        display->print(buffer);
-        display->setTextColor(WHITE); // Restaurer la couleur
+        textInverted = true;
+        drawGlyphs(buffer, length, textX, textY, 1);
+        textInverted = false;
     }
 
-    if (autoRefresh)
-        display->display();
+    markDirty(x, y, width, height);
 }
 
 void OLEDDisplay::drawProgressBarBottom(uint8_t progress, bool showPercentage)
@@ -282,14 +431,9 @@ void OLEDDisplay::printValue(const char *label, float value, uint8_t decimals,
     char valueStr[32];
     dtostrf(value, 0, decimals, valueStr);
 
-    display->setTextSize(size);
-    display->setCursor(0, y);
-    display->print(label);
-    display->print(valueStr);
-    display->print(unit);
-
-    if (autoRefresh)
-        display->display();
+    int16_t x = drawGlyphs(label, strlen(label), 0, y, size);
+    x = drawGlyphs(valueStr, strlen(valueStr), x, y, size);
+    drawGlyphs(unit, strlen(unit), x, y, size);
 }
 
 void OLEDDisplay::printValue(String label, float value, uint8_t decimals,
@@ -313,8 +457,7 @@ void OLEDDisplay::drawBattery(uint8_t x, uint8_t y, uint8_t percentage)
         display->fillRect(x + 2, y + 2, fillWidth, 6, WHITE);
     }
 
-    if (autoRefresh)
-        display->display();
+    markDirty(x, y, 22, 10);
 }
 
 // Signal WiFi
@@ -330,8 +473,7 @@ void OLEDDisplay::drawWifiSignal(uint8_t x, uint8_t y, uint8_t strength)
         display->fillRect(x + (i * 4), y + (8 - barHeight), 3, barHeight, WHITE);
     }
 
-    if (autoRefresh)
-        display->display();
+    markDirty(x, y, 16, 8);
 }
 
 // Combinaisons prédéfinies
@@ -348,7 +490,7 @@ void OLEDDisplay::printImageWithProgress(const uint8_t *bitmap, uint8_t imgWidth
     // Barre de progression en bas
     drawProgressBarBottom(progress, true);
 
-    display->display();
+    flush();
 }
 
 void OLEDDisplay::printImageWithText(const uint8_t *bitmap, uint8_t imgWidth,
@@ -364,7 +506,23 @@ void OLEDDisplay::printImageWithText(const uint8_t *bitmap, uint8_t imgWidth,
     uint8_t textY = imgHeight + 5;
     printTextAligned(text, ALIGN_CENTER, textY, textSize);
 
-    display->display();
+    flush();
+}
+
+void OLEDDisplay::printImageWithProgress(const PageBitmap &image, uint8_t progress)
+{
+    clear();
+    printImage(image, (screenWidth - image.width) / 2, 5); // Centrée en haut
+    drawProgressBarBottom(progress, true);
+    flush();
+}
+
+void OLEDDisplay::printImageWithText(const PageBitmap &image, const char *text, uint8_t textSize)
+{
+    clear();
+    printImage(image, (screenWidth - image.width) / 2, 0);
+    printTextAligned(text, ALIGN_CENTER, image.height + 5, textSize);
+    flush();
 }
 
 // Accès à l'objet Adafruit
@@ -376,5 +534,511 @@ Adafruit_SSD1306 *OLEDDisplay::getDisplay()
 // Refresh manuel
 void OLEDDisplay::refresh()
 {
-    display->display();
+    flush();
+}
+
+// Valide l'image composée ; envoi immédiat, ou par morceaux depuis update() en mode asynchrone
+void OLEDDisplay::flush()
+{
+    commit();
+    if (!asyncFlush)
+    {
+        waitFlush();
+    }
+}
+
+void OLEDDisplay::waitFlush()
+{
+    while (pump(flushBudgetUs))
+    {
+        yield();
+    }
+}
+
+void OLEDDisplay::invalidate()
+{
+    markDirty(0, 0, screenWidth, screenHeight);
+    forceSend = true;
+}
+
+bool OLEDDisplay::isDirty() const
+{
+    for (uint8_t page = 0; page < screenHeight / 8; page++)
+    {
+        if (dirtyMin[page] <= dirtyMax[page])
+            return true;
+    }
+    return false;
+}
+
+bool OLEDDisplay::isFlushing() const
+{
+    if (sendPage != NO_PAGE)
+        return true;
+    for (uint8_t page = 0; page < screenHeight / 8; page++)
+    {
+        if ((pendingMask[page][0] | pendingMask[page][1] | pendingMask[page][2] | pendingMask[page][3]) != 0)
+            return true;
+    }
+    return false;
+}
+
+// Statistiques d'envoi
+uint32_t OLEDDisplay::getFlushCount() const
+{
+    return flushCount;
+}
+
+uint32_t OLEDDisplay::getFlushBytesTotal() const
+{
+    return flushBytesTotal;
+}
+
+uint16_t OLEDDisplay::getLastFlushBytes() const
+{
+    return lastFlushBytes;
+}
+
+uint32_t OLEDDisplay::getLastFlushUs() const
+{
+    return lastFlushUs;
+}
+
+uint32_t OLEDDisplay::getMaxFlushUs() const
+{
+    return maxFlushUs;
+}
+
+uint32_t OLEDDisplay::getMaxUpdateUs() const
+{
+    return maxPumpUs;
+}
+
+uint32_t OLEDDisplay::getComparedBytes() const
+{
+    return comparedBytes;
+}
+
+uint32_t OLEDDisplay::getSkippedBytes() const
+{
+    return skippedBytes;
+}
+
+// Capture
+void OLEDDisplay::setFrameCallback(std::function<void(const uint8_t *frame, uint16_t bytes)> callback)
+{
+    frameCallback = callback;
+}
+
+// PBM binaire : en-tête texte, puis une ligne de pixels par (largeur / 8) octets,
+// bit de poids fort à gauche, 1 = noir. Le buffer est lu page par page, bit y % 8
+// txBuffer est mis à jour par flush(), avant l'envoi : l'envoi en cours est terminé d'abord
+// pour que l'image écrite soit celle de l'écran
+size_t OLEDDisplay::writePBM(Print &out)
+{
+    if (txBuffer == nullptr)
+        return 0;
+    waitFlush();
+
+    size_t written = out.printf("P4\n%u %u\n", screenWidth, screenHeight);
+    uint8_t row[16];
+    const uint8_t rowBytes = screenWidth / 8;
+    for (uint8_t y = 0; y < screenHeight; y++)
+    {
+        const uint8_t *page = txBuffer + (y / 8) * screenWidth;
+        const uint8_t bit = 1 << (y & 7);
+        for (uint8_t i = 0; i < rowBytes; i++)
+        {
+            uint8_t pixels = 0;
+            for (uint8_t x = 0; x < 8; x++)
+            {
+                if ((page[i * 8 + x] & bit) == 0)
+                    pixels |= 0x80 >> x; // Pixel éteint : noir
+            }
+            row[i] = pixels;
+        }
+        written += out.write(row, rowBytes);
+    }
+    return written;
+}
+
+// Méthodes privées
+
+// Rectangle modifié, rogné à l'écran, arrondi aux pages de 8 lignes
+void OLEDDisplay::markDirty(int16_t x, int16_t y, int16_t width, int16_t height)
+{
+    int16_t x2 = x + width - 1;
+    int16_t y2 = y + height - 1;
+    if (x < 0)
+        x = 0;
+    if (y < 0)
+        y = 0;
+    if (x2 >= screenWidth)
+        x2 = screenWidth - 1;
+    if (y2 >= screenHeight)
+        y2 = screenHeight - 1;
+    if (width <= 0 || height <= 0 || x > x2 || y > y2)
+        return;
+
+    for (uint8_t page = y / 8; page <= y2 / 8; page++)
+    {
+        if (x < dirtyMin[page])
+            dirtyMin[page] = x;
+        if (x2 > dirtyMax[page])
+            dirtyMax[page] = x2;
+    }
+}
+
+// Découpage en lignes d'au plus maxWidth pixels : coupure au dernier espace qui tient,
+// au milieu du mot seulement s'il est plus long qu'une ligne. Chaque ligne est mesurée
+// pendant le découpage (un seul passage par caractère, sauf la fin de mot reportée).
+// Renvoie le nombre de lignes ; draw = false : mesure seule
+uint8_t OLEDDisplay::wrapText(const char *text, uint8_t textSize, uint8_t maxWidth,
+                              TextAlign align, int16_t y, bool draw)
+{
+    const uint8_t lineHeight = GLYPH_HEIGHT * textSize;
+    const char *line = text;
+    uint8_t lines = 0;
+
+    while (*line != '\0')
+    {
+        const char *p = line;
+        const char *lastSpace = nullptr;
+        uint16_t width = 0;
+        uint16_t widthAtSpace = 0;
+
+        while (*p != '\0' && *p != '\n')
+        {
+            const uint8_t advance = glyphAdvance(*p) * textSize;
+            if (*p == ' ')
+            {
+                lastSpace = p;
+                widthAtSpace = width;
+            }
+            else if (advance > 0 && width + advance > maxWidth)
+            {
+                break; // Les espaces ne débordent jamais : ils disparaissent en fin de ligne
+            }
+            width += advance;
+            p++;
+        }
+
+        const char *end = p;
+        const char *next = p;
+        if (*p != '\0' && *p != '\n')
+        {
+            if (lastSpace != nullptr)
+            {
+                end = lastSpace;
+                width = widthAtSpace;
+                next = lastSpace + 1;
+            }
+            else if (p == line)
+            {
+                // Un seul glyphe plus large que la ligne : dessiné quand même
+                next = p + 1;
+                while (((uint8_t)*next & 0xC0) == 0x80)
+                    next++;
+                end = next;
+                width = glyphAdvance(*p) * textSize;
+            }
+        }
+        else if (*p == '\n')
+        {
+            next = p + 1;
+        }
+
+        // Espaces de fin de ligne : ni dessinés ni comptés pour l'alignement
+        while (end > line && end[-1] == ' ')
+        {
+            end--;
+            width -= GLYPH_ADVANCE * textSize;
+        }
+
+        if (draw && y < screenHeight)
+        {
+            int16_t x = 0;
+            if (align == ALIGN_CENTER)
+                x = (screenWidth - (int16_t)width) / 2;
+            else if (align == ALIGN_RIGHT)
+                x = screenWidth - (int16_t)width;
+            drawGlyphs(line, end - line, x, y, textSize);
+        }
+        lines++;
+        y += lineHeight;
+
+        // Ligne suivante : sans les espaces de début (sauf après un retour à la ligne explicite)
+        line = next;
+        if (next[-1] != '\n')
+        {
+            while (*line == ' ')
+                line++;
+        }
+    }
+    return lines;
+}
+
+uint16_t OLEDDisplay::textWidth(const char *text, size_t length, uint8_t textSize) const
+{
+    uint16_t width = 0;
+    for (size_t i = 0; i < length; i++)
+    {
+        width += glyphAdvance(text[i]);
+    }
+    return width * textSize;
+}
+
+// Glyphes écrits colonne par colonne dans le buffer (taille 1 à 4 : colonne de 32 pixels
+// au plus). Texte blanc transparent, ou noir sur fond blanc si textInverted.
+// Renvoie le x qui suit le dernier glyphe
+int16_t OLEDDisplay::drawGlyphs(const char *text, size_t length, int16_t x, int16_t y, uint8_t textSize)
+{
+    if (textSize < 1)
+        textSize = 1;
+    if (textSize > 4)
+        textSize = 4;
+
+    const int16_t startX = x;
+    const uint8_t height = GLYPH_HEIGHT * textSize;
+    const uint32_t unit = (1UL << textSize) - 1; // Un pixel agrandi
+    const char *p = text;
+    const char *end = text + length;
+
+    while (p < end && x < screenWidth)
+    {
+        const uint8_t advance = glyphAdvance(*p) * textSize;
+        const uint8_t *glyph = glyphColumns(p);
+        if (glyph == nullptr)
+            continue;
+
+        if (x + advance > 0)
+        {
+            for (uint8_t column = 0; column < GLYPH_ADVANCE; column++)
+            {
+                const uint8_t bits = (column < GLYPH_COLUMNS) ? pgm_read_byte(glyph + column) : 0;
+                if (bits == 0 && !textInverted)
+                    continue;
+
+                // Agrandissement vertical : chaque bit devient textSize bits
+                uint32_t scaled = bits;
+                if (textSize > 1)
+                {
+                    scaled = 0;
+                    for (uint8_t bit = 0; bit < 8; bit++)
+                    {
+                        if (bits & (1 << bit))
+                            scaled |= unit << (bit * textSize);
+                    }
+                }
+                for (uint8_t repeat = 0; repeat < textSize; repeat++)
+                {
+                    drawColumn(x + column * textSize + repeat, y, scaled, height);
+                }
+            }
+        }
+        x += advance;
+    }
+
+    markDirty(startX, y, x - startX, height);
+    return x;
+}
+
+// Colonne de height pixels depuis (x, y), à cheval sur plusieurs pages si y n'est pas
+// multiple de 8 : bits allumés en OU, ou cellule blanche et bits éteints si textInverted
+void OLEDDisplay::drawColumn(int16_t x, int16_t y, uint32_t bits, uint8_t height)
+{
+    if (x < 0 || x >= screenWidth || y >= screenHeight)
+        return;
+
+    uint64_t mask = (height >= 32) ? 0xFFFFFFFFULL : ((1ULL << height) - 1);
+    uint64_t ink = bits & mask;
+    if (y < 0)
+    {
+        mask >>= -y;
+        ink >>= -y;
+        y = 0;
+    }
+    mask <<= (y & 7);
+    ink <<= (y & 7);
+
+    uint8_t *column = display->getBuffer() + x;
+    for (uint8_t page = y / 8; page < screenHeight / 8 && mask != 0; page++)
+    {
+        uint8_t &target = column[page * screenWidth];
+        if (textInverted)
+            target = (target | (uint8_t)mask) & ~(uint8_t)ink;
+        else
+            target |= (uint8_t)ink;
+        mask >>= 8;
+        ink >>= 8;
+    }
+}
+
+// Comparaison des zones modifiées avec l'écran, 4 colonnes à la fois : seules les colonnes
+// différentes sont copiées dans le buffer d'envoi et marquées à envoyer. Le buffer de
+// composition est aussitôt libre pour l'image suivante
+void OLEDDisplay::commit()
+{
+    if (txBuffer == nullptr)
+        return;
+
+    // Les deux buffers sont alloués par malloc() et chaque page fait 128 octets : alignés sur 4
+    const uint8_t *source = display->getBuffer();
+    for (uint8_t page = 0; page < screenHeight / 8; page++)
+    {
+        if (dirtyMin[page] > dirtyMax[page])
+            continue;
+
+        const uint8_t firstWord = dirtyMin[page] / 4;
+        const uint8_t lastWord = dirtyMax[page] / 4;
+        const uint32_t *newWords = (const uint32_t *)(source + page * screenWidth);
+        uint32_t *shownWords = (uint32_t *)(txBuffer + page * screenWidth);
+        comparedBytes += (lastWord - firstWord + 1) * 4;
+
+        for (uint8_t word = firstWord; word <= lastWord; word++)
+        {
+            if (newWords[word] == shownWords[word] && !forceSend)
+            {
+                skippedBytes += 4;
+                continue;
+            }
+
+            // Mot différent : détail par colonne
+            const uint8_t *newBytes = (const uint8_t *)&newWords[word];
+            uint8_t *shownBytes = (uint8_t *)&shownWords[word];
+            for (uint8_t i = 0; i < 4; i++)
+            {
+                const uint8_t column = word * 4 + i;
+                if (newBytes[i] != shownBytes[i] || forceSend)
+                {
+                    shownBytes[i] = newBytes[i];
+                    pendingMask[page][column / 32] |= 1UL << (column % 32);
+                }
+                else
+                {
+                    skippedBytes++;
+                }
+            }
+        }
+        dirtyMin[page] = 0xFF;
+        dirtyMax[page] = 0;
+    }
+    forceSend = false;
+}
+
+// Prochaine fenêtre à envoyer : première colonne en attente, étendue tant que l'écart avec
+// la suivante reste sous SPAN_GAP (moins cher que les 7 octets d'une nouvelle fenêtre)
+bool OLEDDisplay::nextSpan()
+{
+    for (uint8_t page = 0; page < screenHeight / 8; page++)
+    {
+        uint32_t *mask = pendingMask[page];
+        int16_t first = -1;
+        int16_t last = -1;
+        for (uint8_t column = 0; column < screenWidth; column++)
+        {
+            if ((mask[column / 32] & (1UL << (column % 32))) == 0)
+                continue;
+            if (first >= 0 && column - last > SPAN_GAP)
+                break;
+            if (first < 0)
+                first = column;
+            last = column;
+        }
+        if (first < 0)
+            continue;
+
+        for (int16_t column = first; column <= last; column++)
+        {
+            mask[column / 32] &= ~(1UL << (column % 32)); // Une modification pendant l'envoi sera renvoyée
+        }
+        sendPage = page;
+        sendColumn = first;
+        sendEnd = last;
+        return true;
+    }
+    return false;
+}
+
+// Envoi de transactions I2C pendant au plus budgetUs (au moins une)
+// Renvoie true s'il reste des données à envoyer
+bool OLEDDisplay::pump(unsigned long budgetUs)
+{
+    const unsigned long start = micros();
+    bool started = false;
+
+    do
+    {
+        if (sendPage == NO_PAGE)
+        {
+            if (!nextSpan())
+            {
+                break; // Tout est envoyé
+            }
+            if (!started)
+            {
+                Wire.setClock(i2cClock); // Adafruit_SSD1306 rétablit 100 kHz après ses propres commandes
+                started = true;
+            }
+            sendWindow(sendPage, sendColumn, sendEnd);
+        }
+
+        const uint8_t remaining = sendEnd - sendColumn + 1;
+        const uint8_t chunk = remaining > I2C_CHUNK ? I2C_CHUNK : remaining;
+        Wire.beginTransmission(i2cAddress);
+        Wire.write((uint8_t)0x40); // Co = 0, D/C = 1 : données
+        Wire.write(txBuffer + sendPage * screenWidth + sendColumn, chunk);
+        Wire.endTransmission();
+        txBytes += chunk;
+
+        if (sendEnd - sendColumn + 1 == chunk)
+        {
+            sendPage = NO_PAGE;
+        }
+        else
+        {
+            sendColumn += chunk;
+        }
+    } while (micros() - start < budgetUs);
+
+    txUs += micros() - start;
+    if (isFlushing())
+    {
+        return true;
+    }
+
+    // Image entièrement transmise
+    if (txBytes > 0)
+    {
+        lastFlushBytes = txBytes;
+        lastFlushUs = txUs;
+        flushBytesTotal += txBytes;
+        flushCount++;
+        if (lastFlushUs > maxFlushUs)
+        {
+            maxFlushUs = lastFlushUs;
+        }
+        if (frameCallback)
+        {
+            frameCallback(txBuffer, lastFlushBytes);
+        }
+    }
+    txBytes = 0;
+    txUs = 0;
+    return false;
+}
+
+// Fenêtre d'écriture du contrôleur : une page, colonnes [startColumn, endColumn]
+// Les six octets de commande passent en une seule transaction
+void OLEDDisplay::sendWindow(uint8_t page, uint8_t startColumn, uint8_t endColumn)
+{
+    Wire.beginTransmission(i2cAddress);
+    Wire.write((uint8_t)0x00); // Co = 0, D/C = 0 : suite de commandes
+    Wire.write((uint8_t)SSD1306_PAGEADDR);
+    Wire.write(page);
+    Wire.write(page);
+    Wire.write((uint8_t)SSD1306_COLUMNADDR);
+    Wire.write(startColumn);
+    Wire.write(endColumn);
+    Wire.endTransmission();
 }
\ No newline at end of file
@@ -10,6 +10,10 @@
 #include <Arduino.h>
 #include <Adafruit_SSD1306.h>
 #include <Adafruit_GFX.h>
+#include <Wire.h>
+#include <functional>
+#include "PageBitmap.h"
+#include "GlyphFont.h"
 
 // Alignements de texte
 enum TextAlign
@@ -44,12 +48,57 @@ private:
 
     // État actuel
     bool isDisplaying;
+    std::function<void()> updateCallback; // Ex: rotation des écrans (ScreenManager)
+    bool textInverted;                    // Texte noir sur fond blanc (titre d'erreur, pourcentage)
+    std::function<void(const uint8_t *, uint16_t)> frameCallback; // Image transmise (capture)
+
+    // Zones modifiées : par page SSD1306 (8 lignes), colonnes [dirtyMin, dirtyMax]
+    static const uint8_t MAX_PAGES = 8;
+    static const uint8_t I2C_CHUNK = 31; // Octets de données par transaction (+ octet de contrôle)
+    static const uint8_t NO_PAGE = 0xFF;
+    static const uint8_t SPAN_GAP = 8; // Colonnes identiques renvoyées plutôt qu'ouvrir une nouvelle fenêtre
+    uint8_t dirtyMin[MAX_PAGES];
+    uint8_t dirtyMax[MAX_PAGES];
+
+    // Double buffer : le buffer Adafruit sert à composer, txBuffer est la copie de ce que
+    // l'écran affiche une fois les envois terminés. flush() compare les deux et ne retient
+    // que les colonnes différentes (un bit par colonne et par page), envoyées depuis update()
+    uint8_t *txBuffer;
+    uint32_t pendingMask[MAX_PAGES][4];
+    bool forceSend; // Après invalidate() : contenu de l'écran inconnu, pas de comparaison
+    uint8_t sendPage; // Page en cours d'envoi (NO_PAGE : aucune)
+    uint8_t sendColumn;
+    uint8_t sendEnd;
+    bool asyncFlush;
+    uint32_t i2cClock;
+    unsigned long flushBudgetUs; // Temps d'envoi maximum par appel à update()
+
+    // Statistiques d'envoi
+    uint32_t flushCount;
+    uint32_t flushBytesTotal;
+    uint16_t lastFlushBytes;
+    uint32_t lastFlushUs;
+    uint32_t maxFlushUs;
+    uint32_t comparedBytes; // Octets des zones modifiées comparés par flush()
+    uint32_t skippedBytes;  // Dont identiques à l'écran : non envoyés
+    uint16_t txBytes;       // Envoi en cours
+    uint32_t txUs;
+    uint32_t maxPumpUs;
 
     // Méthodes privées utilitaires
     int16_t getAlignedX(const char *text, TextAlign align, uint8_t textSize);
     int16_t getAlignedX(String text, TextAlign align, uint8_t textSize);
     int16_t getVerticalY(VerticalPosition pos, uint8_t textSize);
-    void wrapText(const char *text, uint8_t textSize, uint8_t maxWidth);
+    uint8_t wrapText(const char *text, uint8_t textSize, uint8_t maxWidth,
+                     TextAlign align, int16_t y, bool draw = true);
+    uint16_t textWidth(const char *text, size_t length, uint8_t textSize) const;
+    int16_t drawGlyphs(const char *text, size_t length, int16_t x, int16_t y, uint8_t textSize);
+    void drawColumn(int16_t x, int16_t y, uint32_t bits, uint8_t height);
+    void markDirty(int16_t x, int16_t y, int16_t width, int16_t height);
+    void commit();
+    bool nextSpan();
+    bool pump(unsigned long budgetUs);
+    void sendWindow(uint8_t page, uint8_t startColumn, uint8_t endColumn);
 
 public:
     // Constructeur
@@ -61,12 +110,16 @@ public:
     // Configuration
     void setAutoRefresh(bool enabled);
     void setBrightness(uint8_t brightness); // 0-255
+    void setI2CClock(uint32_t hz);          // 400 kHz par défaut (jusqu'à ~1 MHz selon l'écran)
+    void setAsyncFlush(bool enabled);       // true : flush() ne bloque pas, update() envoie par morceaux
+    void setFlushBudget(unsigned long us);  // Temps d'envoi par appel à update() (2 ms par défaut)
 
     // Gestion de l'affichage temporisé
     void startTimer(unsigned int seconds);
     void stopTimer();
     bool isTimerActive();
-    void update(); // À appeler dans loop() pour gérer le timer
+    void update(); // À appeler dans loop() : timer et envoi des zones modifiées
+    void setUpdateCallback(std::function<void()> callback); // Appelé au début de chaque update()
 
     // Effacement
     void clear();
@@ -76,7 +129,10 @@ public:
     void printText(const char *text, uint8_t x, uint8_t y, uint8_t size = 1);
     void printText(String text, uint8_t x, uint8_t y, uint8_t size = 1);
 
-    // Affichage de texte aligné
+    // Largeur d'un texte UTF-8 en pixels (police intégrée, GlyphFont.h)
+    uint16_t getTextWidth(const char *text, uint8_t size = 1) const;
+
+    // Affichage de texte aligné (sur plusieurs lignes, coupées aux espaces, s'il est trop long)
     void printTextAligned(const char *text, TextAlign align, uint8_t y, uint8_t size = 1);
     void printTextAligned(String text, TextAlign align, uint8_t y, uint8_t size = 1);
 
@@ -87,6 +143,7 @@ public:
     // Affichage de message avec titre
     void printMessage(const char *title, const char *message, unsigned int displayTimeSec = 3);
     void printMessage(String title, String message, unsigned int displayTimeSec = 3);
+    void drawMessage(const char *title, const char *message, bool inverted = false); // Sans envoi ni timer
 
     // Affichage de texte long avec défilement automatique (wrapping)
     void printLongText(const char *text, uint8_t size = 1, unsigned int displayTimeSec = 5);
@@ -97,6 +154,10 @@ public:
                     uint8_t x, uint8_t y);
     void printImageCentered(const uint8_t *bitmap, uint8_t width, uint8_t height);
 
+    // Image au format des pages (PageBitmap.h) : copie octet par octet, sans drawPixel()
+    void printImage(const PageBitmap &image, uint8_t x, uint8_t y);
+    void printImageCentered(const PageBitmap &image);
+
     // Barre de progression
     void drawProgressBar(uint8_t x, uint8_t y, uint8_t width, uint8_t height,
                          uint8_t progress, bool showPercentage = true);
@@ -123,12 +184,35 @@ public:
                                 uint8_t progress);
     void printImageWithText(const uint8_t *bitmap, uint8_t imgWidth, uint8_t imgHeight,
                             const char *text, uint8_t textSize = 1);
+    void printImageWithProgress(const PageBitmap &image, uint8_t progress);
+    void printImageWithText(const PageBitmap &image, const char *text, uint8_t textSize = 1);
 
     // Accès direct à l'objet Adafruit_SSD1306 pour fonctions avancées
     Adafruit_SSD1306 *getDisplay();
 
-    // Refresh manuel
+    // Refresh manuel : valide l'image composée, seules les zones modifiées sont envoyées
     void refresh();
+    void flush();              // Identique à refresh() ; bloquant sauf en mode asynchrone
+    void waitFlush();          // Termine l'envoi en cours (ex: avant un delay())
+    void invalidate();         // Tout renvoyer sans comparaison (après un accès direct via getDisplay())
+    bool isDirty() const;      // Dessins non validés par flush()
+    bool isFlushing() const;   // Image validée pas encore entièrement envoyée
+
+    // Statistiques d'envoi (octets de données I2C, temps de bus par image)
+    uint32_t getFlushCount() const;
+    uint32_t getFlushBytesTotal() const;
+    uint16_t getLastFlushBytes() const;
+    uint32_t getLastFlushUs() const;
+    uint32_t getMaxFlushUs() const;
+    uint32_t getMaxUpdateUs() const; // Plus long envoi fait par un appel à update()
+    uint32_t getComparedBytes() const; // Octets des zones dessinées, comparés à l'écran
+    uint32_t getSkippedBytes() const;  // Dont identiques à l'écran : économisés
+
+    // Capture de l'image affichée (copie de l'écran, pas le buffer de composition)
+    // Callback appelé quand l'envoi est terminé : buffer au format des pages (largeur x
+    // hauteur / 8 octets) et octets de données I2C envoyés depuis la fin de l'envoi précédent
+    void setFrameCallback(std::function<void(const uint8_t *frame, uint16_t bytes)> callback);
+    size_t writePBM(Print &out); // Image PBM binaire (P4) : pixel allumé = blanc ; termine l'envoi en cours
 };
 
 #endif // OLED_DISPLAY_H
\ No newline at end of file
@@ -0,0 +1,61 @@
+/*
+ * PageBitmap.h
+ * Images au format mémoire du SSD1306 : une colonne de 8 pixels par octet (bit 0 en haut),
+ * pages de 8 lignes les unes après les autres
+ * - Conversion à la compilation (constexpr) depuis le format de drawBitmap()
+ *   (lignes, bit de poids fort à gauche)
+ * - Copie octet par octet dans le buffer de l'écran (OLEDDisplay::printImage)
+ */
+
+#ifndef PAGE_BITMAP_H
+#define PAGE_BITMAP_H
+
+#include <Arduino.h>
+
+// Référence vers une image convertie (données en PROGMEM)
+struct PageBitmap
+{
+    uint8_t width;
+    uint8_t height;
+    const uint8_t *data; // width * ((height + 7) / 8) octets
+};
+
+// Image convertie, stockable en PROGMEM
+template <uint8_t W, uint8_t H>
+struct PageImage
+{
+    static const uint8_t PAGES = (H + 7) / 8;
+    uint8_t data[W * PAGES];
+
+    PageBitmap bitmap() const
+    {
+        return PageBitmap{W, H, data};
+    }
+};
+
+// Conversion du format drawBitmap() (lignes de (W + 7) / 8 octets) vers le format des pages
+// À utiliser dans une initialisation constexpr : aucun coût à l'exécution
+template <uint8_t W, uint8_t H>
+constexpr PageImage<W, H> toPageImage(const unsigned char (&rows)[((W + 7) / 8) * H])
+{
+    PageImage<W, H> image{};
+    for (uint8_t page = 0; page < PageImage<W, H>::PAGES; page++)
+    {
+        for (uint8_t x = 0; x < W; x++)
+        {
+            uint8_t column = 0;
+            for (uint8_t bit = 0; bit < 8; bit++)
+            {
+                const uint16_t y = page * 8 + bit;
+                if (y < H && (rows[y * ((W + 7) / 8) + x / 8] & (0x80 >> (x % 8))) != 0)
+                {
+                    column |= 1 << bit;
+                }
+            }
+            image.data[page * W + x] = column;
+        }
+    }
+    return image;
+}
+
+#endif // PAGE_BITMAP_H
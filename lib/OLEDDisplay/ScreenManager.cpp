@@ -0,0 +1,335 @@
+/*
+ * ScreenManager.cpp
+ * Implémentation de la gestion des écrans et de la file de messages
+ */
+
+#include "ScreenManager.h"
+
+// Constructeur
+ScreenManager::ScreenManager(OLEDDisplay &oled, unsigned long sliceMs) : oled(oled)
+{
+    this->sliceMs = sliceMs;
+    nextId = 1;
+    nextOrder = 0;
+    current = nullptr;
+
+    userScreen = SCREEN_BLANK;
+    userScreenStart = 0;
+    userScreenMs = 0;
+
+    visibleScreen = SCREEN_BLANK;
+    visibleId = 0;
+    shownAt = 0;
+    needsRender = false;
+
+    renderCount = 0;
+    coalescedCount = 0;
+    droppedCount = 0;
+
+    for (uint8_t i = 0; i < SCREEN_COUNT; i++)
+    {
+        renderers[i] = nullptr;
+    }
+    for (uint8_t i = 0; i < MAX_MESSAGES; i++)
+    {
+        messages[i].id = 0;
+    }
+}
+
+void ScreenManager::begin()
+{
+    oled.setUpdateCallback([this]()
+                           { update(); });
+}
+
+void ScreenManager::setRenderer(ScreenType screen, ScreenRenderer renderer)
+{
+    if (screen < SCREEN_COUNT)
+    {
+        renderers[screen] = renderer;
+    }
+}
+
+// Écran déclaré : prioritaire sur la file, le message visible reprendra ensuite
+void ScreenManager::showScreen(ScreenType screen, unsigned int seconds)
+{
+    if (current != nullptr)
+    {
+        suspendCurrent(false);
+    }
+    userScreen = screen;
+    userScreenStart = millis();
+    userScreenMs = seconds * 1000UL;
+    needsRender = true; // Même écran : redessiné avec des données à jour
+    update();
+}
+
+// Messages
+bool ScreenManager::showMessage(const char *title, const char *text, unsigned int seconds, MessagePriority priority)
+{
+    const unsigned long durationMs = seconds * 1000UL;
+
+    ScreenMessage *duplicate = findDuplicate(title, text);
+    if (duplicate != nullptr)
+    {
+        // Doublon : durée prolongée si besoin, priorité la plus haute conservée
+        const unsigned long elapsed = (duplicate == current) ? millis() - shownAt : 0;
+        if (elapsed + durationMs > duplicate->remainingMs)
+        {
+            duplicate->remainingMs = elapsed + durationMs;
+        }
+        if (priority > duplicate->priority)
+        {
+            duplicate->priority = priority;
+        }
+        if (duplicate->repeats < 255)
+        {
+            duplicate->repeats++;
+        }
+        coalescedCount++;
+        update();
+        return true;
+    }
+
+    ScreenMessage *message = allocate(priority);
+    if (message == nullptr)
+    {
+        droppedCount++;
+        Serial.println(F("[Ecran] File pleine, message ignoré"));
+        return false;
+    }
+
+    message->id = nextId++;
+    if (nextId == 0)
+    {
+        nextId = 1; // 0 est réservé aux emplacements libres
+    }
+    strncpy(message->title, title != nullptr ? title : "", sizeof(message->title) - 1);
+    message->title[sizeof(message->title) - 1] = '\0';
+    strncpy(message->text, text != nullptr ? text : "", sizeof(message->text) - 1);
+    message->text[sizeof(message->text) - 1] = '\0';
+    message->priority = priority;
+    message->remainingMs = durationMs;
+    message->order = nextOrder++;
+    message->repeats = 0;
+    message->yielded = false;
+
+    update(); // Affiché tout de suite si l'écran est libre ou moins prioritaire
+    return true;
+}
+
+bool ScreenManager::showMessage(String title, String text, unsigned int seconds, MessagePriority priority)
+{
+    return showMessage(title.c_str(), text.c_str(), seconds, priority);
+}
+
+bool ScreenManager::showError(const char *title, const char *text, unsigned int seconds)
+{
+    return showMessage(title, text, seconds, PRIORITY_ERROR);
+}
+
+void ScreenManager::refresh()
+{
+    needsRender = true;
+    update();
+}
+
+// Rotation : fin de l'écran déclaré, fin ou interruption du message visible, puis message suivant
+void ScreenManager::update()
+{
+    const unsigned long now = millis();
+
+    if (userScreen != SCREEN_BLANK && now - userScreenStart >= userScreenMs)
+    {
+        userScreen = SCREEN_BLANK;
+    }
+
+    if (userScreen == SCREEN_BLANK)
+    {
+        if (current != nullptr)
+        {
+            const unsigned long elapsed = now - shownAt;
+            ScreenMessage *next = selectNext();
+            if (elapsed >= current->remainingMs)
+            {
+                current->id = 0; // Terminé
+                current = nullptr;
+            }
+            else if (next != nullptr && next->priority >= PRIORITY_HIGH && next->priority > current->priority)
+            {
+                suspendCurrent(false); // Interrompu, reprendra selon sa priorité
+            }
+            else if (next != nullptr && elapsed >= sliceMs)
+            {
+                suspendCurrent(true); // Tranche écoulée : laisse passer les messages en attente
+            }
+        }
+
+        if (current == nullptr)
+        {
+            current = selectNext();
+            if (current != nullptr)
+            {
+                current->yielded = false;
+                shownAt = now;
+            }
+        }
+    }
+
+    // Écran visible : rendu seulement s'il change
+    ScreenType screen = SCREEN_BLANK;
+    uint32_t id = 0;
+    if (userScreen != SCREEN_BLANK)
+    {
+        screen = userScreen;
+    }
+    else if (current != nullptr)
+    {
+        screen = (current->priority == PRIORITY_ERROR) ? SCREEN_ERROR : SCREEN_MESSAGE;
+        id = current->id;
+    }
+
+    if (needsRender || screen != visibleScreen || id != visibleId)
+    {
+        visibleScreen = screen;
+        visibleId = id;
+        render();
+    }
+}
+
+// État et statistiques
+ScreenType ScreenManager::getVisibleScreen() const
+{
+    return visibleScreen;
+}
+
+const ScreenMessage *ScreenManager::getVisibleMessage() const
+{
+    return (visibleScreen == SCREEN_MESSAGE || visibleScreen == SCREEN_ERROR) ? current : nullptr;
+}
+
+uint8_t ScreenManager::getQueuedCount() const
+{
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < MAX_MESSAGES; i++)
+    {
+        if (messages[i].id != 0 && &messages[i] != current)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+uint32_t ScreenManager::getRenderCount() const
+{
+    return renderCount;
+}
+
+uint32_t ScreenManager::getCoalescedCount() const
+{
+    return coalescedCount;
+}
+
+uint32_t ScreenManager::getDroppedCount() const
+{
+    return droppedCount;
+}
+
+// Méthodes privées
+
+ScreenMessage *ScreenManager::findDuplicate(const char *title, const char *text)
+{
+    for (uint8_t i = 0; i < MAX_MESSAGES; i++)
+    {
+        ScreenMessage &message = messages[i];
+        if (message.id != 0 && strncmp(message.title, title, sizeof(message.title) - 1) == 0 &&
+            strncmp(message.text, text, sizeof(message.text) - 1) == 0)
+        {
+            return &message;
+        }
+    }
+    return nullptr;
+}
+
+// Emplacement libre, sinon le plus ancien des messages en attente les moins prioritaires
+// (strictement moins que le nouveau) ; le message visible n'est jamais remplacé
+ScreenMessage *ScreenManager::allocate(MessagePriority priority)
+{
+    ScreenMessage *victim = nullptr;
+    for (uint8_t i = 0; i < MAX_MESSAGES; i++)
+    {
+        ScreenMessage &message = messages[i];
+        if (message.id == 0)
+        {
+            return &message;
+        }
+        if (&message != current && message.priority < priority &&
+            (victim == nullptr || message.priority < victim->priority ||
+             (message.priority == victim->priority && (int32_t)(message.order - victim->order) < 0)))
+        {
+            victim = &message;
+        }
+    }
+    if (victim != nullptr)
+    {
+        droppedCount++;
+    }
+    return victim;
+}
+
+// Prochain message : ceux qui n'ont pas encore cédé leur tour d'abord, puis priorité, puis ordre d'arrivée
+ScreenMessage *ScreenManager::selectNext()
+{
+    ScreenMessage *best = nullptr;
+    for (uint8_t i = 0; i < MAX_MESSAGES; i++)
+    {
+        ScreenMessage &message = messages[i];
+        if (message.id == 0 || &message == current)
+        {
+            continue;
+        }
+        if (best == nullptr ||
+            (!message.yielded && best->yielded) ||
+            (message.yielded == best->yielded &&
+             (message.priority > best->priority ||
+              (message.priority == best->priority && (int32_t)(message.order - best->order) < 0))))
+        {
+            best = &message;
+        }
+    }
+    return best;
+}
+
+// Retour du message visible dans la file avec son temps restant
+void ScreenManager::suspendCurrent(bool yielded)
+{
+    const unsigned long elapsed = millis() - shownAt;
+    current->remainingMs = (elapsed < current->remainingMs) ? current->remainingMs - elapsed : 0;
+    current->yielded = yielded;
+    current->order = nextOrder++;
+    current = nullptr;
+}
+
+void ScreenManager::render()
+{
+    needsRender = false;
+    renderCount++;
+
+    switch (visibleScreen)
+    {
+    case SCREEN_MESSAGE:
+    case SCREEN_ERROR:
+        oled.drawMessage(current->title, current->text, visibleScreen == SCREEN_ERROR);
+        break;
+
+    default:
+        oled.clear();
+        if (renderers[visibleScreen])
+        {
+            renderers[visibleScreen]();
+        }
+        break;
+    }
+    oled.flush();
+}
@@ -0,0 +1,124 @@
+/*
+ * ScreenManager.h
+ * Gestion des écrans OLED : écrans déclarés (accueil, infos...) et file de messages
+ * temporisés par priorité
+ * - Un message n'en efface plus un autre : il attend son tour
+ * - Doublons regroupés (même titre et même texte)
+ * - Un message long (ex: erreur de 15 min) laisse passer les messages en attente
+ *   toutes les sliceMs, puis reprend
+ * - Rotation depuis oled.update() ; rendu uniquement quand l'écran visible change
+ */
+
+#ifndef SCREEN_MANAGER_H
+#define SCREEN_MANAGER_H
+
+#include <Arduino.h>
+#include <functional>
+#include "OLEDDisplay.h"
+
+enum ScreenType
+{
+    SCREEN_BLANK,   // Rien à afficher : écran éteint
+    SCREEN_HOME,    // Écran d'accueil (rendu fourni par l'application)
+    SCREEN_INFO,    // Écran d'informations (rendu fourni par l'application)
+    SCREEN_MESSAGE, // Message de la file
+    SCREEN_ERROR,   // Message de priorité PRIORITY_ERROR (titre en négatif)
+    SCREEN_COUNT
+};
+
+enum MessagePriority
+{
+    PRIORITY_LOW,
+    PRIORITY_NORMAL,
+    PRIORITY_HIGH, // Interrompt un message de priorité inférieure (qui reprendra ensuite)
+    PRIORITY_ERROR
+};
+
+struct ScreenMessage
+{
+    uint32_t id; // 0 : emplacement libre
+    char title[16];
+    char text[96];
+    MessagePriority priority;
+    unsigned long remainingMs; // Temps d'affichage restant
+    uint32_t order;            // Ordre d'arrivée dans la file (FIFO à priorité égale)
+    uint8_t repeats;           // Doublons regroupés
+    bool yielded;              // A laissé passer les autres : repris quand plus personne n'attend
+};
+
+class ScreenManager
+{
+public:
+    typedef std::function<void()> ScreenRenderer;
+
+    static const uint8_t MAX_MESSAGES = 6;
+
+    // Constructeur
+    ScreenManager(OLEDDisplay &oled, unsigned long sliceMs = 5000);
+
+    // Branche la rotation sur oled.update()
+    void begin();
+
+    // Écrans déclarés : le rendu ne fait que dessiner (effacement et envoi faits ici)
+    void setRenderer(ScreenType screen, ScreenRenderer renderer);
+
+    // Affichage immédiat d'un écran déclaré, puis retour à la file
+    void showScreen(ScreenType screen, unsigned int seconds);
+
+    // Messages : renvoient false si la file est pleine de messages plus prioritaires
+    bool showMessage(const char *title, const char *text, unsigned int seconds,
+                     MessagePriority priority = PRIORITY_NORMAL);
+    bool showMessage(String title, String text, unsigned int seconds,
+                     MessagePriority priority = PRIORITY_NORMAL);
+    bool showError(const char *title, const char *text, unsigned int seconds);
+
+    // Redessine l'écran visible (contenu modifié ou écran écrasé par un dessin direct)
+    void refresh();
+
+    // Rotation (appelée par oled.update() après begin())
+    void update();
+
+    // État et statistiques
+    ScreenType getVisibleScreen() const;
+    const ScreenMessage *getVisibleMessage() const; // nullptr si aucun message affiché
+    uint8_t getQueuedCount() const;                 // Messages en attente, hors message visible
+    uint32_t getRenderCount() const;
+    uint32_t getCoalescedCount() const;
+    uint32_t getDroppedCount() const;
+
+private:
+    OLEDDisplay &oled;
+    ScreenRenderer renderers[SCREEN_COUNT];
+    unsigned long sliceMs;
+
+    // File de messages (le message visible y reste)
+    ScreenMessage messages[MAX_MESSAGES];
+    uint32_t nextId;
+    uint32_t nextOrder;
+    ScreenMessage *current; // Message visible
+
+    // Écran déclaré affiché par showScreen()
+    ScreenType userScreen;
+    unsigned long userScreenStart;
+    unsigned long userScreenMs;
+
+    // Écran effectivement affiché
+    ScreenType visibleScreen;
+    uint32_t visibleId;
+    unsigned long shownAt; // Début d'affichage du message visible
+    bool needsRender;
+
+    // Statistiques
+    uint32_t renderCount;
+    uint32_t coalescedCount;
+    uint32_t droppedCount;
+
+    // Méthodes privées
+    ScreenMessage *findDuplicate(const char *title, const char *text);
+    ScreenMessage *allocate(MessagePriority priority);
+    ScreenMessage *selectNext();
+    void suspendCurrent(bool yielded);
+    void render();
+};
+
+#endif // SCREEN_MANAGER_H
@@ -28,6 +28,10 @@ RTCManager::RTCManager(uint8_t clk, uint8_t dat, uint8_t rst)
     onMidnight = nullptr;
     midnightTriggered = false;
 
+    lastSyncOffset = 0;
+    lastSyncMillis = 0;
+    syncCount = 0;
+
     // Initialiser les alarmes
     for (int i = 0; i < MAX_ALARMS; i++)
     {
@@ -146,12 +150,22 @@ bool RTCManager::syncFromNTP(long gmtOffset, int dstOffset)
 
     // Récupérer l'heure NTP
     time_t now = time(nullptr);
-    struct tm *timeinfo = localtime(&now);
+    struct tm timeinfo = *localtime(&now); // Copie : update() ci-dessous ne doit pas l'écraser
+
+    // Écart du RTC avant correction, ramené sur ±12 h (le changement de jour n'est pas un écart)
+    long offset = (long)(timeinfo.tm_hour * 3600L + timeinfo.tm_min * 60L + timeinfo.tm_sec) - (long)getSecondsFromMidnight();
+    if (offset > 43200L)
+        offset -= 86400L;
+    else if (offset < -43200L)
+        offset += 86400L;
+    lastSyncOffset = offset;
+    lastSyncMillis = millis();
+    syncCount++;
 
     // Configurer le RTC
-    setDateTime(timeinfo->tm_sec, timeinfo->tm_min, timeinfo->tm_hour,
-                timeinfo->tm_wday + 1, timeinfo->tm_mday,
-                timeinfo->tm_mon + 1, timeinfo->tm_year + 1900);
+    setDateTime(timeinfo.tm_sec, timeinfo.tm_min, timeinfo.tm_hour,
+                timeinfo.tm_wday + 1, timeinfo.tm_mday,
+                timeinfo.tm_mon + 1, timeinfo.tm_year + 1900);
 
     if (debugMode)
     {
@@ -161,6 +175,21 @@ bool RTCManager::syncFromNTP(long gmtOffset, int dstOffset)
     update();
     return true;
 }
+
+long RTCManager::getLastSyncOffset() const
+{
+    return lastSyncOffset;
+}
+
+unsigned long RTCManager::getLastSyncMillis() const
+{
+    return lastSyncMillis;
+}
+
+uint32_t RTCManager::getSyncCount() const
+{
+    return syncCount;
+}
 #endif
 
 // Lecture de l'heure
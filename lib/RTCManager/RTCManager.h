@@ -66,6 +66,11 @@ private:
     MidnightCallback onMidnight;
     bool midnightTriggered;
 
+    // Dernière synchronisation NTP
+    long lastSyncOffset;
+    unsigned long lastSyncMillis;
+    uint32_t syncCount;
+
     // Alarmes multiples
     struct Alarm
     {
@@ -104,6 +109,9 @@ public:
 // Synchronisation avec NTP (nécessite WiFi)
 #ifdef ESP8266
     bool syncFromNTP(long gmtOffset = 0, int dstOffset = 0);
+    long getLastSyncOffset() const;         // Écart NTP - RTC (s) mesuré à la dernière synchronisation
+    unsigned long getLastSyncMillis() const; // millis() de la dernière synchronisation réussie
+    uint32_t getSyncCount() const;           // Synchronisations réussies depuis le démarrage
 #endif
 
     // Lecture de l'heure
@@ -0,0 +1,223 @@
+/*
+ * ServoDriver.cpp
+ * Implémentation du pilotage du servomoteur par profils de mouvement
+ */
+
+#include "ServoDriver.h"
+
+// Constructeur
+ServoDriver::ServoDriver(uint8_t pin, uint16_t minUs, uint16_t maxUs)
+{
+    this->pin = pin;
+    this->minUs = minUs;
+    this->maxUs = maxUs;
+    head = 0;
+    count = 0;
+    fromUs = currentUs = endUs = (minUs + maxUs) / 2;
+    segmentStartUs = 0;
+    idleSinceMs = 0;
+    settleMs = 300;
+    autoDetach = true;
+    attachedFlag = false;
+    attachedSinceMs = 0;
+    attachedTotalMs = 0;
+    attachCount = 0;
+}
+
+void ServoDriver::begin(int angle)
+{
+    const uint16_t pulseUs = angleToUs(angle);
+    fromUs = currentUs = endUs = pulseUs;
+    attach();
+    hold(600); // Course complète possible depuis une position inconnue
+}
+
+// Séquence
+bool ServoDriver::moveTo(int angle, uint16_t durationMs)
+{
+    return push(angleToUs(angle), durationMs);
+}
+
+bool ServoDriver::moveToUs(uint16_t pulseUs, uint16_t durationMs)
+{
+    return push(constrain(pulseUs, minUs, maxUs), durationMs);
+}
+
+bool ServoDriver::hold(uint16_t durationMs)
+{
+    return push(endUs, durationMs);
+}
+
+// Une place reste libre après la secousse pour le mouvement de retour (ex: fermeture de la valve)
+bool ServoDriver::shake(int amplitude, uint8_t cycles, uint16_t periodMs)
+{
+    if (count + 2 * cycles + 1 > MAX_SEGMENTS)
+    {
+        Serial.println(F("[Servo] ✗ Séquence pleine, secousse ignorée"));
+        return false;
+    }
+
+    const uint16_t baseUs = endUs;
+    const int32_t awayUs = constrain((int32_t)baseUs + (int32_t)amplitude * (maxUs - minUs) / 180,
+                                     (int32_t)minUs, (int32_t)maxUs);
+    for (uint8_t i = 0; i < cycles; i++)
+    {
+        push(awayUs, periodMs / 2);
+        push(baseUs, periodMs / 2);
+    }
+    return true;
+}
+
+void ServoDriver::update()
+{
+    if (count == 0)
+    {
+        if (attachedFlag && autoDetach && millis() - idleSinceMs >= settleMs)
+        {
+            detach();
+        }
+        return;
+    }
+
+    const uint32_t nowUs = micros();
+    while (count > 0)
+    {
+        const Segment &segment = segments[head];
+        const uint32_t elapsedUs = nowUs - segmentStartUs;
+        if (elapsedUs < segment.durationUs)
+        {
+            writePulse(easeInOut(fromUs, segment.targetUs, elapsedUs, segment.durationUs));
+            return;
+        }
+
+        // Segment terminé : le suivant part de l'échéance prévue, sans dérive due à loop()
+        writePulse(segment.targetUs);
+        fromUs = segment.targetUs;
+        segmentStartUs += segment.durationUs;
+        head = (head + 1) % MAX_SEGMENTS;
+        count--;
+    }
+    idleSinceMs = millis();
+}
+
+void ServoDriver::waitMove()
+{
+    while (count > 0)
+    {
+        update();
+        yield();
+    }
+}
+
+void ServoDriver::stop()
+{
+    count = 0;
+    fromUs = endUs = currentUs;
+    idleSinceMs = millis();
+}
+
+// Configuration
+void ServoDriver::setSettleTime(uint16_t ms)
+{
+    settleMs = ms;
+}
+
+void ServoDriver::setAutoDetach(bool enabled)
+{
+    autoDetach = enabled;
+}
+
+// État
+bool ServoDriver::isMoving() const
+{
+    return count > 0;
+}
+
+bool ServoDriver::isAttached() const
+{
+    return attachedFlag;
+}
+
+uint16_t ServoDriver::getPulseUs() const
+{
+    return currentUs;
+}
+
+int ServoDriver::getAngle() const
+{
+    return ((uint32_t)(currentUs - minUs) * 180 + (maxUs - minUs) / 2) / (maxUs - minUs);
+}
+
+uint32_t ServoDriver::getAttachedMs() const
+{
+    return attachedTotalMs + (attachedFlag ? millis() - attachedSinceMs : 0);
+}
+
+uint32_t ServoDriver::getAttachCount() const
+{
+    return attachCount;
+}
+
+// Méthodes privées
+bool ServoDriver::push(uint16_t targetUs, uint16_t durationMs)
+{
+    if (count >= MAX_SEGMENTS)
+    {
+        Serial.println(F("[Servo] ✗ Séquence pleine"));
+        return false;
+    }
+
+    Segment &segment = segments[(head + count) % MAX_SEGMENTS];
+    segment.targetUs = targetUs;
+    segment.durationUs = durationMs * 1000UL;
+    endUs = targetUs;
+    if (++count == 1)
+    {
+        attach();
+        fromUs = currentUs;
+        segmentStartUs = micros();
+    }
+    return true;
+}
+
+void ServoDriver::writePulse(uint16_t pulseUs)
+{
+    if (pulseUs == currentUs)
+        return;
+    currentUs = pulseUs;
+    servo.writeMicroseconds(pulseUs);
+}
+
+void ServoDriver::attach()
+{
+    if (attachedFlag)
+        return;
+
+    // Consigne donnée avant attach() : pas d'impulsion au neutre le temps d'une trame
+    servo.writeMicroseconds(currentUs);
+    servo.attach(pin, minUs, maxUs);
+    servo.writeMicroseconds(currentUs);
+    attachedFlag = true;
+    attachedSinceMs = millis();
+    attachCount++;
+}
+
+void ServoDriver::detach()
+{
+    servo.detach();
+    attachedFlag = false;
+    attachedTotalMs += millis() - attachedSinceMs;
+}
+
+uint16_t ServoDriver::angleToUs(int angle) const
+{
+    return minUs + (uint32_t)(maxUs - minUs) * constrain(angle, 0, 180) / 180;
+}
+
+// Profil en S (smoothstep 3f² - 2f³), en virgule fixe sur 1024 : vitesse nulle aux deux extrémités
+uint16_t ServoDriver::easeInOut(uint16_t fromUs, uint16_t toUs, uint32_t elapsedUs, uint32_t durationUs)
+{
+    const uint32_t f = (uint64_t)elapsedUs * 1024 / durationUs;
+    const uint32_t s = (f * f * (3 * 1024 - 2 * f)) >> 20;
+    return fromUs + ((int32_t)toUs - (int32_t)fromUs) * (int32_t)s / 1024;
+}
@@ -0,0 +1,89 @@
+/*
+ * ServoDriver.h
+ * Pilotage d'un servomoteur par profils de mouvement, sans le laisser attaché au repos
+ * - Mouvements en rampe (accélération et décélération douces), consigne en microsecondes
+ * - Séquence de segments (rampe, maintien, secousse) déroulée par update() depuis loop()
+ * - Détachement automatique une fois le dernier mouvement stabilisé : sur ESP8266, la PWM
+ *   logicielle du servo cesse alors de déclencher une interruption toutes les 20 ms
+ * - Temps passé attaché et nombre d'attachements, pour les métriques
+ */
+
+#ifndef SERVO_DRIVER_H
+#define SERVO_DRIVER_H
+
+#include <Arduino.h>
+#include <Servo.h>
+
+class ServoDriver
+{
+public:
+    static const uint8_t MAX_SEGMENTS = 12;
+
+    // Constructeur : impulsions de 0° et 180° (valeurs par défaut de la bibliothèque Servo)
+    ServoDriver(uint8_t pin, uint16_t minUs = 544, uint16_t maxUs = 2400);
+
+    // Position initiale, atteinte sans rampe (position réelle inconnue), puis détachement
+    void begin(int angle);
+
+    // Séquence : false si la file de segments est pleine (rien n'est ajouté)
+    bool moveTo(int angle, uint16_t durationMs);        // Rampe depuis la fin du segment précédent
+    bool moveToUs(uint16_t pulseUs, uint16_t durationMs);
+    bool hold(uint16_t durationMs);                      // Maintien de la position
+    bool shake(int amplitude, uint8_t cycles, uint16_t periodMs); // Allers-retours de amplitude degrés (signée) ;
+                                                                  // false s'il ne reste pas une place après eux
+
+    // À appeler dans loop() : avance la séquence, détache le servo une fois stabilisé
+    void update();
+    void waitMove(); // Bloquant : déroule la séquence jusqu'au dernier segment (avec yield())
+    void stop();     // Abandonne la séquence à la position courante
+
+    // Configuration
+    void setSettleTime(uint16_t ms); // Attente après le dernier segment avant de détacher (défaut 300 ms)
+    void setAutoDetach(bool enabled); // false : le servo reste attaché (maintien du couple)
+
+    // État
+    bool isMoving() const;
+    bool isAttached() const;
+    uint16_t getPulseUs() const; // Consigne courante
+    int getAngle() const;
+    uint32_t getAttachedMs() const; // Cumul depuis le démarrage, période en cours comprise
+    uint32_t getAttachCount() const;
+
+private:
+    struct Segment
+    {
+        uint16_t targetUs;
+        uint32_t durationUs;
+    };
+
+    Servo servo;
+    uint8_t pin;
+    uint16_t minUs;
+    uint16_t maxUs;
+
+    Segment segments[MAX_SEGMENTS];
+    uint8_t head;  // Segment en cours
+    uint8_t count; // Segments en file, celui en cours compris
+    uint16_t fromUs;    // Consigne au début du segment en cours
+    uint16_t currentUs; // Dernière consigne envoyée
+    uint16_t endUs;     // Consigne à la fin de la séquence (départ du prochain segment ajouté)
+    uint32_t segmentStartUs;
+    unsigned long idleSinceMs; // Fin du dernier segment
+
+    uint16_t settleMs;
+    bool autoDetach;
+    bool attachedFlag;
+    unsigned long attachedSinceMs;
+    uint32_t attachedTotalMs;
+    uint32_t attachCount;
+
+    // Méthodes privées
+    bool push(uint16_t targetUs, uint16_t durationMs);
+    void writePulse(uint16_t pulseUs);
+    void attach();
+    void detach();
+    uint16_t angleToUs(int angle) const;
+    static uint16_t easeInOut(uint16_t fromUs, uint16_t toUs, uint32_t elapsedUs, uint32_t durationUs);
+};
+
+#endif // SERVO_DRIVER_H
@@ -0,0 +1,196 @@
+/*
+ * EventStream.cpp
+ * Implémentation du canal Server-Sent Events
+ */
+
+#include "EventStream.h"
+
+// Constructeur
+EventStream::EventStream(uint8_t maxClients)
+{
+    server = nullptr;
+    uri = "/events";
+    this->maxClients = maxClients;
+    if (this->maxClients > MAX_CLIENTS)
+        this->maxClients = MAX_CLIENTS;
+
+    lastKeepAlive = 0;
+    rejectedCount = 0;
+    droppedCount = 0;
+}
+
+// Initialisation
+bool EventStream::begin(WebServerType *server, const char *uri)
+{
+    if (server == nullptr)
+    {
+        Serial.println(F("[SSE] Impossible de démarrer: serveur web absent"));
+        return false;
+    }
+
+    this->server = server;
+    this->uri = uri;
+    server->on(uri, HTTP_GET, [this]()
+               { handleSubscribe(); });
+
+    Serial.print(F("[SSE] Flux d'événements sur "));
+    Serial.print(uri);
+    Serial.print(F(" (max "));
+    Serial.print(maxClients);
+    Serial.println(F(" clients)"));
+    return true;
+}
+
+void EventStream::handle()
+{
+    // Libérer les emplacements des clients déconnectés
+    for (uint8_t i = 0; i < maxClients; i++)
+    {
+        if (clients[i] && !clients[i].connected())
+        {
+            clients[i].stop();
+            clients[i] = WiFiClient();
+        }
+    }
+
+    // Keep-alive : évite la fermeture par les proxys et détecte les clients partis
+    if (millis() - lastKeepAlive >= KEEPALIVE_MS)
+    {
+        lastKeepAlive = millis();
+        static const char ping[] = ": ping\n\n";
+        for (uint8_t i = 0; i < maxClients; i++)
+        {
+            if (clients[i])
+            {
+                writeTo(clients[i], ping, sizeof(ping) - 1);
+            }
+        }
+    }
+}
+
+// Envoi d'un événement
+uint8_t EventStream::send(const char *event, const char *data, size_t length, uint32_t id)
+{
+    // En-tête de l'événement (pile)
+    char head[48];
+    int headLength;
+    if (id != 0)
+    {
+        headLength = snprintf(head, sizeof(head), "id: %lu\nevent: %s\ndata: ", (unsigned long)id, event);
+    }
+    else
+    {
+        headLength = snprintf(head, sizeof(head), "event: %s\ndata: ", event);
+    }
+    if (headLength < 0 || (size_t)headLength >= sizeof(head))
+        return 0;
+
+    uint8_t delivered = 0;
+    for (uint8_t i = 0; i < maxClients; i++)
+    {
+        if (!clients[i])
+            continue;
+
+#ifdef ESP8266
+        // Coût borné : le message doit tenir dans le tampon TCP, sinon le client est trop lent
+        if ((size_t)clients[i].availableForWrite() < headLength + length + 2)
+        {
+            droppedCount++;
+            Serial.println(F("[SSE] Client trop lent, déconnecté"));
+            clients[i].stop();
+            clients[i] = WiFiClient();
+            continue;
+        }
+#endif
+        if (writeTo(clients[i], head, headLength) &&
+            writeTo(clients[i], data, length) &&
+            writeTo(clients[i], "\n\n", 2))
+        {
+            delivered++;
+        }
+    }
+    return delivered;
+}
+
+uint8_t EventStream::send(const char *event, const char *data)
+{
+    return send(event, data, strlen(data));
+}
+
+// Informations
+uint8_t EventStream::getClientCount()
+{
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < maxClients; i++)
+    {
+        if (clients[i] && clients[i].connected())
+            count++;
+    }
+    return count;
+}
+
+uint8_t EventStream::getMaxClients() const
+{
+    return maxClients;
+}
+
+uint32_t EventStream::getRejectedCount() const
+{
+    return rejectedCount;
+}
+
+uint32_t EventStream::getDroppedCount() const
+{
+    return droppedCount;
+}
+
+// Méthodes privées
+void EventStream::handleSubscribe()
+{
+    handle(); // Libère d'abord les emplacements morts
+
+    int slot = -1;
+    for (uint8_t i = 0; i < maxClients; i++)
+    {
+        if (!clients[i])
+        {
+            slot = i;
+            break;
+        }
+    }
+
+    if (slot < 0)
+    {
+        rejectedCount++;
+        Serial.println(F("[SSE] Nombre maximum de flux atteint"));
+        server->sendHeader(F("Retry-After"), F("30"));
+        server->send(503, "text/plain", "Trop de flux ouverts");
+        return;
+    }
+
+    // Réponse écrite directement sur la socket : la connexion reste ouverte
+    WiFiClient client = server->client();
+    client.print(F("HTTP/1.1 200 OK\r\n"
+                   "Content-Type: text/event-stream\r\n"
+                   "Cache-Control: no-cache\r\n"
+                   "Connection: keep-alive\r\n\r\n"));
+    client.printf("retry: %lu\n\n", RETRY_MS);
+    clients[slot] = client;
+
+    Serial.print(F("[SSE] Nouveau client ("));
+    Serial.print(getClientCount());
+    Serial.print('/');
+    Serial.print(maxClients);
+    Serial.println(')');
+}
+
+bool EventStream::writeTo(WiFiClient &client, const char *data, size_t length)
+{
+    if (client.write((const uint8_t *)data, length) != length)
+    {
+        client.stop();
+        client = WiFiClient();
+        return false;
+    }
+    return true;
+}
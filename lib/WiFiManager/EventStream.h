@@ -0,0 +1,57 @@
+/*
+ * EventStream.h
+ * Canal Server-Sent Events (text/event-stream) pour pousser des événements aux navigateurs
+ * Nombre de flux simultanés plafonné, coût par client borné
+ */
+
+#ifndef EVENT_STREAM_H
+#define EVENT_STREAM_H
+
+#include <Arduino.h>
+#include "WiFiManager.h" // WebServerType
+
+class EventStream
+{
+public:
+    static const uint8_t MAX_CLIENTS = 4;            // Plafond absolu (mémoire réservée)
+    static const unsigned long KEEPALIVE_MS = 15000; // Commentaire ": ping" périodique
+    static const unsigned long RETRY_MS = 5000;      // Délai de reconnexion conseillé au navigateur
+
+    // Constructeur
+    EventStream(uint8_t maxClients = 2);
+
+    // Initialisation : enregistre la route sur le serveur
+    bool begin(WebServerType *server, const char *uri = "/events");
+
+    // À appeler dans loop() : keep-alive et nettoyage des clients déconnectés
+    void handle();
+
+    // Envoi d'un événement à tous les clients (data sur une seule ligne)
+    // Un client dont le tampon TCP ne peut pas absorber le message est déconnecté
+    uint8_t send(const char *event, const char *data, size_t length, uint32_t id = 0);
+    uint8_t send(const char *event, const char *data);
+
+    // Informations
+    uint8_t getClientCount();
+    uint8_t getMaxClients() const;
+    uint32_t getRejectedCount() const; // Connexions refusées (plafond atteint)
+    uint32_t getDroppedCount() const;  // Clients trop lents déconnectés
+
+private:
+    WebServerType *server;
+    const char *uri;
+    uint8_t maxClients;
+
+    WiFiClient clients[MAX_CLIENTS];
+    unsigned long lastKeepAlive;
+
+    // Statistiques
+    uint32_t rejectedCount;
+    uint32_t droppedCount;
+
+    // Méthodes privées
+    void handleSubscribe();
+    bool writeTo(WiFiClient &client, const char *data, size_t length);
+};
+
+#endif // EVENT_STREAM_H
@@ -6,9 +6,10 @@
 class HomePage
 {
 public:
-  static String getHTML()
+  // Page stockée en flash (PROGMEM) : envoyée avec send_P, sans copie en RAM
+  static PGM_P getHTML()
   {
-    String html = R"rawliteral(
+    static const char html[] PROGMEM = R"rawliteral(
 <!DOCTYPE html>
 <html>
 <head>
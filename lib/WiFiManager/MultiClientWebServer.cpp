@@ -0,0 +1,860 @@
+/*
+ * MultiClientWebServer.cpp
+ * Implémentation du serveur HTTP multi-connexions
+ */
+
+#include "MultiClientWebServer.h"
+
+static const String vide;
+static WiFiClient aucunClient;
+
+// Constructeur
+MultiClientWebServer::MultiClientWebServer(uint16_t port) : server(port)
+{
+    for (uint8_t i = 0; i < MAX_CONNECTIONS; i++)
+    {
+        connections[i].active = false;
+        connections[i].length = 0;
+        connections[i].headerLength = 0;
+        connections[i].contentLength = 0;
+        connections[i].requests = 0;
+        connections[i].buffer[0] = '\0';
+    }
+    routeCount = 0;
+    notFoundHandler = nullptr;
+
+    current = nullptr;
+    currentMethod = HTTP_GET;
+    keepAlive = false;
+    argCount = 0;
+    headerCount = 0;
+    resetResponse();
+
+    requestCount = 0;
+    timeoutCount = 0;
+    rejectedCount = 0;
+    evictedCount = 0;
+}
+
+// Démarrage / arrêt
+void MultiClientWebServer::begin()
+{
+    server.begin();
+    server.setNoDelay(true);
+}
+
+void MultiClientWebServer::stop()
+{
+    for (uint8_t i = 0; i < MAX_CONNECTIONS; i++)
+    {
+        if (connections[i].active)
+        {
+            closeConnection(connections[i]);
+        }
+    }
+    server.stop();
+}
+
+void MultiClientWebServer::close()
+{
+    stop();
+}
+
+void MultiClientWebServer::handleClient()
+{
+    acceptClients();
+
+    for (uint8_t i = 0; i < MAX_CONNECTIONS; i++)
+    {
+        Connection &c = connections[i];
+        if (!c.active)
+            continue;
+
+        if (readConnection(c))
+        {
+            handleRequest(c);
+            continue;
+        }
+        if (!c.active)
+            continue; // Fermée pendant la lecture (requête trop grande)
+
+        // Délais : une connexion lente ou muette ne retient jamais la boucle
+        if (c.length > 0)
+        {
+            if (millis() - c.requestStart > REQUEST_TIMEOUT_MS)
+            {
+                timeoutCount++;
+                sendError(c, 408);
+            }
+        }
+        else if (!c.client.connected() || millis() - c.idleSince > KEEPALIVE_TIMEOUT_MS)
+        {
+            closeConnection(c);
+        }
+    }
+}
+
+// Routes
+void MultiClientWebServer::on(const String &uri, THandlerFunction handler)
+{
+    on(uri, HTTP_ANY, handler);
+}
+
+void MultiClientWebServer::on(const String &uri, HTTPMethod method, THandlerFunction handler)
+{
+    if (routeCount >= MAX_ROUTES)
+    {
+        Serial.print(F("[Web] Trop de routes, ignorée : "));
+        Serial.println(uri);
+        return;
+    }
+    routes[routeCount].uri = uri;
+    routes[routeCount].method = method;
+    routes[routeCount].handler = handler;
+    routeCount++;
+}
+
+void MultiClientWebServer::onNotFound(THandlerFunction handler)
+{
+    notFoundHandler = handler;
+}
+
+// Requête courante
+const String &MultiClientWebServer::uri() const
+{
+    return currentUri;
+}
+
+HTTPMethod MultiClientWebServer::method() const
+{
+    return currentMethod;
+}
+
+WiFiClient &MultiClientWebServer::client()
+{
+    return current != nullptr ? current->client : aucunClient;
+}
+
+const String &MultiClientWebServer::arg(const String &name) const
+{
+    for (uint8_t i = 0; i < argCount; i++)
+    {
+        if (argNames[i] == name)
+            return argValues[i];
+    }
+    return vide;
+}
+
+const String &MultiClientWebServer::arg(int i) const
+{
+    return (i >= 0 && i < argCount) ? argValues[i] : vide;
+}
+
+const String &MultiClientWebServer::argName(int i) const
+{
+    return (i >= 0 && i < argCount) ? argNames[i] : vide;
+}
+
+int MultiClientWebServer::args() const
+{
+    return argCount;
+}
+
+bool MultiClientWebServer::hasArg(const String &name) const
+{
+    for (uint8_t i = 0; i < argCount; i++)
+    {
+        if (argNames[i] == name)
+            return true;
+    }
+    return false;
+}
+
+void MultiClientWebServer::collectHeaders(const char *headerKeys[], const size_t headerKeysCount)
+{
+    headerCount = 0;
+    for (size_t i = 0; i < headerKeysCount && headerCount < MAX_COLLECTED_HEADERS; i++)
+    {
+        headerNames[headerCount] = headerKeys[i];
+        headerValues[headerCount] = "";
+        headerCount++;
+    }
+}
+
+const String &MultiClientWebServer::header(const String &name) const
+{
+    for (uint8_t i = 0; i < headerCount; i++)
+    {
+        if (headerNames[i].equalsIgnoreCase(name))
+            return headerValues[i];
+    }
+    return vide;
+}
+
+bool MultiClientWebServer::hasHeader(const String &name) const
+{
+    return header(name).length() > 0;
+}
+
+// Réponse
+void MultiClientWebServer::sendHeader(const String &name, const String &value, bool first)
+{
+    const size_t needed = name.length() + value.length() + 4; // "name: value\r\n"
+    if (responseHeadersLength + needed >= RESPONSE_HEADERS_SIZE)
+    {
+        Serial.print(F("[Web] En-tête ignoré (tampon plein) : "));
+        Serial.println(name);
+        return;
+    }
+
+    char *dest = responseHeaders + responseHeadersLength;
+    if (first)
+    {
+        memmove(responseHeaders + needed, responseHeaders, responseHeadersLength);
+        dest = responseHeaders;
+    }
+    memcpy(dest, name.c_str(), name.length());
+    dest += name.length();
+    memcpy(dest, ": ", 2);
+    dest += 2;
+    memcpy(dest, value.c_str(), value.length());
+    dest += value.length();
+    memcpy(dest, "\r\n", 2);
+
+    responseHeadersLength += needed;
+    responseHeaders[responseHeadersLength] = '\0';
+}
+
+void MultiClientWebServer::setContentLength(size_t contentLength)
+{
+    this->contentLength = contentLength;
+}
+
+void MultiClientWebServer::send(int code, const char *contentType, const String &content)
+{
+    send(code, contentType, content.c_str(), content.length());
+}
+
+void MultiClientWebServer::send(int code, const String &contentType, const String &content)
+{
+    send(code, contentType.c_str(), content.c_str(), content.length());
+}
+
+void MultiClientWebServer::send(int code, const char *contentType, const char *content)
+{
+    send(code, contentType, content, content != nullptr ? strlen(content) : 0);
+}
+
+void MultiClientWebServer::send(int code, const char *contentType, const char *content, size_t length)
+{
+    if (current == nullptr || responseStarted)
+        return;
+
+    sendHead(code, contentType, length);
+    if (length > 0)
+    {
+        sendContent(content, length);
+    }
+}
+
+void MultiClientWebServer::send_P(int code, PGM_P contentType, PGM_P content)
+{
+    send_P(code, contentType, content, strlen_P(content));
+}
+
+void MultiClientWebServer::send_P(int code, PGM_P contentType, PGM_P content, size_t length)
+{
+    if (current == nullptr || responseStarted)
+        return;
+
+    char type[48];
+    strncpy_P(type, contentType, sizeof(type) - 1);
+    type[sizeof(type) - 1] = '\0';
+
+    sendHead(code, type, length);
+    if (length > 0)
+    {
+        sendContent_P(content, length);
+    }
+}
+
+void MultiClientWebServer::sendContent(const char *content, size_t length)
+{
+    if (current == nullptr || currentMethod == HTTP_HEAD)
+        return;
+
+    if (chunked)
+    {
+        char size[12];
+        const int n = snprintf(size, sizeof(size), "%X\r\n", (unsigned)length);
+        writeData(size, n);
+        if (length > 0)
+        {
+            writeData(content, length);
+        }
+        writeData("\r\n", 2); // Chunk vide : fin de la réponse
+        if (length == 0)
+        {
+            chunked = false;
+        }
+    }
+    else
+    {
+        writeData(content, length);
+    }
+}
+
+void MultiClientWebServer::sendContent(const char *content)
+{
+    sendContent(content, strlen(content));
+}
+
+void MultiClientWebServer::sendContent(const String &content)
+{
+    sendContent(content.c_str(), content.length());
+}
+
+void MultiClientWebServer::sendContent_P(PGM_P content)
+{
+    sendContent_P(content, strlen_P(content));
+}
+
+void MultiClientWebServer::sendContent_P(PGM_P content, size_t length)
+{
+    if (current == nullptr || currentMethod == HTTP_HEAD)
+        return;
+
+    if (chunked)
+    {
+        char size[12];
+        const int n = snprintf(size, sizeof(size), "%X\r\n", (unsigned)length);
+        writeData(size, n);
+        if (length > 0)
+        {
+            writeData_P(content, length);
+        }
+        writeData("\r\n", 2);
+        if (length == 0)
+        {
+            chunked = false;
+        }
+    }
+    else
+    {
+        writeData_P(content, length);
+    }
+}
+
+// Statistiques
+uint8_t MultiClientWebServer::getActiveConnections() const
+{
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < MAX_CONNECTIONS; i++)
+    {
+        if (connections[i].active)
+            count++;
+    }
+    return count;
+}
+
+uint32_t MultiClientWebServer::getRequestCount() const
+{
+    return requestCount;
+}
+
+uint32_t MultiClientWebServer::getTimeoutCount() const
+{
+    return timeoutCount;
+}
+
+uint32_t MultiClientWebServer::getRejectedCount() const
+{
+    return rejectedCount;
+}
+
+uint32_t MultiClientWebServer::getEvictedCount() const
+{
+    return evictedCount;
+}
+
+// Méthodes privées
+void MultiClientWebServer::acceptClients()
+{
+    while (server.hasClient())
+    {
+        Connection *slot = nullptr;
+        for (uint8_t i = 0; i < MAX_CONNECTIONS && slot == nullptr; i++)
+        {
+            if (!connections[i].active)
+                slot = &connections[i];
+        }
+
+        // Plus de place : on sacrifie la connexion keep-alive inactive la plus ancienne
+        if (slot == nullptr)
+        {
+            const unsigned long now = millis();
+            for (uint8_t i = 0; i < MAX_CONNECTIONS; i++)
+            {
+                Connection &c = connections[i];
+                if (c.length == 0 && (slot == nullptr || now - c.idleSince > now - slot->idleSince))
+                    slot = &c;
+            }
+            if (slot != nullptr)
+            {
+                closeConnection(*slot);
+                evictedCount++;
+            }
+        }
+
+        WiFiClient client = server.available();
+        if (slot == nullptr)
+        {
+            rejectedCount++;
+            client.print(F("HTTP/1.1 503 Service Unavailable\r\n"
+                           "Retry-After: 1\r\n"
+                           "Content-Length: 0\r\n"
+                           "Connection: close\r\n\r\n"));
+            client.stop();
+            continue;
+        }
+
+        client.setNoDelay(true);
+        client.setTimeout(REQUEST_TIMEOUT_MS); // Borne aussi les écritures vers un client bloqué
+        slot->client = client;
+        slot->active = true;
+        slot->length = 0;
+        slot->headerLength = 0;
+        slot->contentLength = 0;
+        slot->requests = 0;
+        slot->buffer[0] = '\0';
+        slot->idleSince = millis();
+    }
+}
+
+// Lecture non bloquante : renvoie true quand une requête complète est dans le tampon
+bool MultiClientWebServer::readConnection(Connection &c)
+{
+    int available = c.client.available();
+    if (available > 0)
+    {
+        const size_t space = REQUEST_BUFFER_SIZE - c.length;
+        if (space == 0)
+        {
+            rejectedCount++;
+            sendError(c, c.headerLength > 0 ? 413 : 431);
+            return false;
+        }
+        if ((size_t)available > space)
+            available = space;
+
+        const int n = c.client.read((uint8_t *)c.buffer + c.length, available);
+        if (n > 0)
+        {
+            if (c.length == 0)
+                c.requestStart = millis();
+            c.length += n;
+            c.buffer[c.length] = '\0';
+        }
+    }
+    if (c.length == 0)
+        return false;
+
+    if (c.headerLength == 0)
+    {
+        const char *end = strstr(c.buffer, "\r\n\r\n");
+        if (end == nullptr)
+        {
+            if (c.length >= REQUEST_BUFFER_SIZE)
+            {
+                rejectedCount++;
+                sendError(c, 431);
+            }
+            return false;
+        }
+        c.headerLength = end - c.buffer + 4;
+
+        // Content-Length : seul en-tête nécessaire avant l'analyse complète
+        c.contentLength = 0;
+        for (const char *line = strstr(c.buffer, "\r\n"); line != nullptr && line < end; line = strstr(line + 2, "\r\n"))
+        {
+            if (strncasecmp(line + 2, "Content-Length:", 15) == 0)
+            {
+                c.contentLength = strtoul(line + 17, nullptr, 10);
+                break;
+            }
+        }
+        if (c.contentLength > REQUEST_BUFFER_SIZE - c.headerLength)
+        {
+            rejectedCount++;
+            sendError(c, 413);
+            return false;
+        }
+    }
+    return c.length >= c.headerLength + c.contentLength;
+}
+
+void MultiClientWebServer::handleRequest(Connection &c)
+{
+    current = &c;
+    resetRequest();
+    resetResponse();
+    c.requests++;
+    requestCount++;
+
+    if (!parseRequest(c))
+    {
+        current = nullptr;
+        rejectedCount++;
+        sendError(c, 400);
+        return;
+    }
+
+    THandlerFunction *handler = nullptr;
+    for (uint8_t i = 0; i < routeCount && handler == nullptr; i++)
+    {
+        if (routes[i].uri == currentUri && (routes[i].method == HTTP_ANY || routes[i].method == currentMethod))
+            handler = &routes[i].handler;
+    }
+    if (handler != nullptr)
+    {
+        (*handler)();
+    }
+    else if (notFoundHandler)
+    {
+        notFoundHandler();
+    }
+    else
+    {
+        send(404, "text/plain", "Not found");
+    }
+    current = nullptr;
+
+    if (!responseStarted)
+    {
+        // Aucune réponse : le handler a repris la connexion (ex: flux SSE), on libère l'emplacement
+        c.client = WiFiClient();
+        c.active = false;
+        c.length = 0;
+        c.headerLength = 0;
+        c.contentLength = 0;
+        return;
+    }
+
+    if (keepAlive && c.client.connected())
+    {
+        // Conserver les octets d'une éventuelle requête suivante (pipelining)
+        const size_t used = c.headerLength + c.contentLength;
+        memmove(c.buffer, c.buffer + used, c.length - used);
+        c.length -= used;
+        c.buffer[c.length] = '\0';
+        c.headerLength = 0;
+        c.contentLength = 0;
+        c.requestStart = millis();
+        c.idleSince = millis();
+    }
+    else
+    {
+        closeConnection(c);
+    }
+}
+
+// Analyse en place de la requête (ligne, en-têtes, arguments)
+bool MultiClientWebServer::parseRequest(Connection &c)
+{
+    char *buffer = c.buffer;
+    buffer[c.headerLength - 2] = '\0'; // Fin des en-têtes
+
+    // Ligne de requête : "GET /chemin?a=1 HTTP/1.1"
+    char *eol = strstr(buffer, "\r\n");
+    if (eol == nullptr)
+        return false;
+    *eol = '\0';
+
+    char *target = strchr(buffer, ' ');
+    if (target == nullptr)
+        return false;
+    *target++ = '\0';
+    char *version = strchr(target, ' ');
+    if (version == nullptr)
+        return false;
+    *version++ = '\0';
+
+    if (strcmp(buffer, "GET") == 0)
+        currentMethod = HTTP_GET;
+    else if (strcmp(buffer, "POST") == 0)
+        currentMethod = HTTP_POST;
+    else if (strcmp(buffer, "PUT") == 0)
+        currentMethod = HTTP_PUT;
+    else if (strcmp(buffer, "PATCH") == 0)
+        currentMethod = HTTP_PATCH;
+    else if (strcmp(buffer, "DELETE") == 0)
+        currentMethod = HTTP_DELETE;
+    else if (strcmp(buffer, "OPTIONS") == 0)
+        currentMethod = HTTP_OPTIONS;
+    else if (strcmp(buffer, "HEAD") == 0)
+        currentMethod = HTTP_HEAD;
+    else
+        return false;
+
+    keepAlive = strcmp(version, "HTTP/1.1") == 0; // HTTP/1.0 : fermeture par défaut
+
+    char *query = strchr(target, '?');
+    if (query != nullptr)
+        *query++ = '\0';
+    currentUri = target;
+
+    // En-têtes
+    const char *contentType = nullptr;
+    char *line = eol + 2;
+    while (*line != '\0')
+    {
+        char *next = strstr(line, "\r\n");
+        if (next != nullptr)
+            *next = '\0';
+
+        char *colon = strchr(line, ':');
+        if (colon != nullptr)
+        {
+            *colon = '\0';
+            char *value = colon + 1;
+            while (*value == ' ')
+                value++;
+
+            if (strcasecmp(line, "Connection") == 0)
+            {
+                if (strcasecmp(value, "close") == 0)
+                    keepAlive = false;
+                else if (strcasecmp(value, "keep-alive") == 0)
+                    keepAlive = true;
+            }
+            else if (strcasecmp(line, "Content-Type") == 0)
+            {
+                contentType = value;
+            }
+            for (uint8_t i = 0; i < headerCount; i++)
+            {
+                if (headerNames[i].equalsIgnoreCase(line))
+                    headerValues[i] = value;
+            }
+        }
+
+        if (next == nullptr)
+            break;
+        line = next + 2;
+    }
+
+    if (c.requests >= KEEPALIVE_MAX_REQUESTS)
+        keepAlive = false;
+
+    // Arguments : query string puis corps
+    if (query != nullptr)
+        parseArguments(query);
+
+    if (c.contentLength > 0)
+    {
+        // Terminaison temporaire : l'octet suivant peut appartenir à la requête suivante
+        char *body = buffer + c.headerLength;
+        const char suivant = body[c.contentLength];
+        body[c.contentLength] = '\0';
+        if (contentType != nullptr && strncasecmp(contentType, "application/x-www-form-urlencoded", 33) == 0)
+            parseArguments(body);
+        else
+            addArgument("plain", body); // Même convention que ESP8266WebServer
+        body[c.contentLength] = suivant;
+    }
+    return true;
+}
+
+void MultiClientWebServer::parseArguments(char *query)
+{
+    char *pair = query;
+    while (pair != nullptr && *pair != '\0')
+    {
+        char *next = strchr(pair, '&');
+        if (next != nullptr)
+            *next++ = '\0';
+
+        char *value = strchr(pair, '=');
+        if (value != nullptr)
+            *value++ = '\0';
+
+        if (*pair != '\0')
+            addArgument(urlDecode(pair), value != nullptr ? urlDecode(value) : String(""));
+        pair = next;
+    }
+}
+
+void MultiClientWebServer::addArgument(const String &name, const String &value)
+{
+    if (argCount >= MAX_ARGS)
+        return;
+    argNames[argCount] = name;
+    argValues[argCount] = value;
+    argCount++;
+}
+
+void MultiClientWebServer::resetRequest()
+{
+    argCount = 0;
+    for (uint8_t i = 0; i < headerCount; i++)
+    {
+        headerValues[i] = "";
+    }
+    keepAlive = false;
+}
+
+void MultiClientWebServer::resetResponse()
+{
+    responseHeaders[0] = '\0';
+    responseHeadersLength = 0;
+    contentLength = CONTENT_LENGTH_NOT_SET;
+    responseStarted = false;
+    chunked = false;
+}
+
+void MultiClientWebServer::sendHead(int code, const char *contentType, size_t length)
+{
+    responseStarted = true;
+    if (contentLength != CONTENT_LENGTH_NOT_SET)
+        length = contentLength; // Fixée par setContentLength()
+    chunked = (length == CONTENT_LENGTH_UNKNOWN);
+
+    char line[96];
+    int n = snprintf(line, sizeof(line), "HTTP/1.1 %d %s\r\n", code, statusText(code));
+    writeData(line, n);
+    if (contentType != nullptr && *contentType != '\0')
+    {
+        n = snprintf(line, sizeof(line), "Content-Type: %s\r\n", contentType);
+        if (n >= (int)sizeof(line))
+            n = sizeof(line) - 1;
+        writeData(line, n);
+    }
+    if (chunked)
+    {
+        n = snprintf(line, sizeof(line), "Transfer-Encoding: chunked\r\n");
+    }
+    else
+    {
+        n = snprintf(line, sizeof(line), "Content-Length: %u\r\n", (unsigned)length);
+    }
+    writeData(line, n);
+    n = snprintf(line, sizeof(line), "Connection: %s\r\n", keepAlive ? "keep-alive" : "close");
+    writeData(line, n);
+    writeData(responseHeaders, responseHeadersLength);
+    writeData("\r\n", 2);
+}
+
+void MultiClientWebServer::writeData(const char *data, size_t length)
+{
+    if (length == 0 || current == nullptr)
+        return;
+    if (current->client.write((const uint8_t *)data, length) != length)
+    {
+        keepAlive = false; // Client bloqué ou parti : connexion fermée après le handler
+    }
+}
+
+void MultiClientWebServer::writeData_P(PGM_P data, size_t length)
+{
+    if (length == 0 || current == nullptr)
+        return;
+#ifdef ESP8266
+    if (current->client.write_P(data, length) != length)
+#else
+    if (current->client.write((const uint8_t *)data, length) != length)
+#endif
+    {
+        keepAlive = false;
+    }
+}
+
+void MultiClientWebServer::sendError(Connection &c, int code)
+{
+    char response[128];
+    const int n = snprintf(response, sizeof(response),
+                           "HTTP/1.1 %d %s\r\nContent-Length: 0\r\nConnection: close\r\n\r\n",
+                           code, statusText(code));
+    c.client.write((const uint8_t *)response, n);
+    closeConnection(c);
+
+    Serial.print(F("[Web] Connexion fermée : "));
+    Serial.print(code);
+    Serial.print(' ');
+    Serial.println(statusText(code));
+}
+
+void MultiClientWebServer::closeConnection(Connection &c)
+{
+    c.client.stop();
+    c.client = WiFiClient();
+    c.active = false;
+    c.length = 0;
+    c.headerLength = 0;
+    c.contentLength = 0;
+    c.buffer[0] = '\0';
+}
+
+const char *MultiClientWebServer::statusText(int code)
+{
+    switch (code)
+    {
+    case 200:
+        return "OK";
+    case 202:
+        return "Accepted";
+    case 204:
+        return "No Content";
+    case 301:
+        return "Moved Permanently";
+    case 302:
+        return "Found";
+    case 304:
+        return "Not Modified";
+    case 400:
+        return "Bad Request";
+    case 404:
+        return "Not Found";
+    case 405:
+        return "Method Not Allowed";
+    case 408:
+        return "Request Timeout";
+    case 409:
+        return "Conflict";
+    case 413:
+        return "Payload Too Large";
+    case 429:
+        return "Too Many Requests";
+    case 431:
+        return "Request Header Fields Too Large";
+    case 500:
+        return "Internal Server Error";
+    case 503:
+        return "Service Unavailable";
+    default:
+        return "";
+    }
+}
+
+String MultiClientWebServer::urlDecode(const char *text)
+{
+    String decoded;
+    decoded.reserve(strlen(text));
+    for (const char *p = text; *p != '\0'; p++)
+    {
+        if (*p == '+')
+        {
+            decoded += ' ';
+        }
+        else if (*p == '%' && isxdigit((uint8_t)p[1]) && isxdigit((uint8_t)p[2]))
+        {
+            const char hex[3] = {p[1], p[2], '\0'};
+            decoded += (char)strtol(hex, nullptr, 16);
+            p += 2;
+        }
+        else
+        {
+            decoded += *p;
+        }
+    }
+    return decoded;
+}
@@ -0,0 +1,158 @@
+/*
+ * MultiClientWebServer.h
+ * Serveur HTTP multi-connexions non bloquant, alternative à ESP8266WebServer
+ * Même API que le serveur du core pour le sous-ensemble utilisé par WiFiManager :
+ * chaque connexion est lue par morceaux dans un tampon borné, seule une requête
+ * complète déclenche son handler. Keep-alive et délai maximum par requête.
+ * Activation : build flag -D WIFI_MANAGER_MULTI_CLIENT
+ */
+
+#ifndef MULTI_CLIENT_WEB_SERVER_H
+#define MULTI_CLIENT_WEB_SERVER_H
+
+#include <Arduino.h>
+#include <functional>
+
+#ifdef ESP8266
+#include <ESP8266WiFi.h>
+#include <ESP8266WebServer.h> // HTTPMethod, CONTENT_LENGTH_UNKNOWN
+#elif defined(ESP32)
+#include <WiFi.h>
+#include <WebServer.h>
+#endif
+
+class MultiClientWebServer
+{
+public:
+    typedef std::function<void(void)> THandlerFunction;
+
+    static const uint8_t MAX_CONNECTIONS = 4;             // Connexions simultanées
+    static const size_t REQUEST_BUFFER_SIZE = 1024;       // Ligne de requête + en-têtes + corps
+    static const uint8_t MAX_ROUTES = 32;
+    static const uint8_t MAX_ARGS = 8;
+    static const uint8_t MAX_COLLECTED_HEADERS = 4;
+    static const size_t RESPONSE_HEADERS_SIZE = 256;      // En-têtes ajoutés par sendHeader()
+    static const unsigned long REQUEST_TIMEOUT_MS = 2000; // Requête incomplète ou écriture bloquée
+    static const unsigned long KEEPALIVE_TIMEOUT_MS = 5000;
+    static const uint8_t KEEPALIVE_MAX_REQUESTS = 20;
+
+    // Constructeur
+    MultiClientWebServer(uint16_t port = 80);
+
+    // Démarrage / arrêt
+    void begin();
+    void stop();
+    void close();
+    void handleClient(); // À appeler dans loop() : au plus une requête par connexion et par appel
+
+    // Routes
+    void on(const String &uri, THandlerFunction handler);
+    void on(const String &uri, HTTPMethod method, THandlerFunction handler);
+    void onNotFound(THandlerFunction handler);
+
+    // Requête courante
+    const String &uri() const;
+    HTTPMethod method() const;
+    WiFiClient &client();
+    const String &arg(const String &name) const; // "plain" : corps brut (hors formulaire)
+    const String &arg(int i) const;
+    const String &argName(int i) const;
+    int args() const;
+    bool hasArg(const String &name) const;
+    void collectHeaders(const char *headerKeys[], const size_t headerKeysCount);
+    const String &header(const String &name) const;
+    bool hasHeader(const String &name) const;
+
+    // Réponse
+    void sendHeader(const String &name, const String &value, bool first = false);
+    void setContentLength(size_t contentLength); // CONTENT_LENGTH_UNKNOWN => chunked
+    void send(int code, const char *contentType = nullptr, const String &content = String(""));
+    void send(int code, const String &contentType, const String &content);
+    void send(int code, const char *contentType, const char *content);
+    void send(int code, const char *contentType, const char *content, size_t contentLength);
+    void send_P(int code, PGM_P contentType, PGM_P content);
+    void send_P(int code, PGM_P contentType, PGM_P content, size_t contentLength);
+    void sendContent(const char *content, size_t length);
+    void sendContent(const char *content);
+    void sendContent(const String &content);
+    void sendContent_P(PGM_P content);
+    void sendContent_P(PGM_P content, size_t length);
+
+    // Statistiques
+    uint8_t getActiveConnections() const;
+    uint32_t getRequestCount() const;
+    uint32_t getTimeoutCount() const;  // Requêtes incomplètes abandonnées (408)
+    uint32_t getRejectedCount() const; // Connexions refusées (503) ou requêtes trop grandes
+    uint32_t getEvictedCount() const;  // Connexions keep-alive inactives fermées pour faire de la place
+
+private:
+    struct Connection
+    {
+        WiFiClient client;
+        bool active;
+        char buffer[REQUEST_BUFFER_SIZE + 1]; // +1 : '\0' final
+        size_t length;
+        size_t headerLength;  // 0 tant que la fin des en-têtes n'est pas reçue
+        size_t contentLength; // Taille annoncée du corps
+        unsigned long requestStart;
+        unsigned long idleSince;
+        uint8_t requests;
+    };
+
+    struct Route
+    {
+        String uri;
+        HTTPMethod method;
+        THandlerFunction handler;
+    };
+
+    WiFiServer server;
+    Connection connections[MAX_CONNECTIONS];
+    Route routes[MAX_ROUTES];
+    uint8_t routeCount;
+    THandlerFunction notFoundHandler;
+
+    // Requête courante
+    Connection *current;
+    String currentUri;
+    HTTPMethod currentMethod;
+    bool keepAlive;
+    String argNames[MAX_ARGS];
+    String argValues[MAX_ARGS];
+    uint8_t argCount;
+    String headerNames[MAX_COLLECTED_HEADERS];
+    String headerValues[MAX_COLLECTED_HEADERS];
+    uint8_t headerCount;
+
+    // Réponse courante
+    char responseHeaders[RESPONSE_HEADERS_SIZE];
+    size_t responseHeadersLength;
+    size_t contentLength;
+    bool responseStarted;
+    bool chunked;
+
+    // Statistiques
+    uint32_t requestCount;
+    uint32_t timeoutCount;
+    uint32_t rejectedCount;
+    uint32_t evictedCount;
+
+    // Méthodes privées
+    void acceptClients();
+    bool readConnection(Connection &c);
+    void handleRequest(Connection &c);
+    bool parseRequest(Connection &c);
+    void parseArguments(char *query);
+    void addArgument(const String &name, const String &value);
+    void resetRequest();
+    void resetResponse();
+    void sendHead(int code, const char *contentType, size_t length);
+    void writeData(const char *data, size_t length);
+    void writeData_P(PGM_P data, size_t length);
+    void sendError(Connection &c, int code);
+    void closeConnection(Connection &c);
+    static const char *statusText(int code);
+    static String urlDecode(const char *text);
+};
+
+#endif // MULTI_CLIENT_WEB_SERVER_H
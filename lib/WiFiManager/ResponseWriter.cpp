@@ -0,0 +1,268 @@
+/*
+ * ResponseWriter.cpp
+ * Implémentation de l'écriture en flux des réponses HTTP
+ */
+
+#include "ResponseWriter.h"
+
+// Constructeur
+ResponseWriter::ResponseWriter(WebServerType &server) : server(server)
+{
+    length = 0;
+    started = false;
+    finished = false;
+
+    bytesSent = 0;
+    chunkCount = 0;
+    heapAtBegin = 0;
+    heapMin = 0;
+}
+
+ResponseWriter::~ResponseWriter()
+{
+    if (started && !finished)
+    {
+        end();
+    }
+}
+
+// Début de réponse : en-têtes sans Content-Length => chunked
+void ResponseWriter::begin(int code, const char *contentType)
+{
+    heapAtBegin = ESP.getFreeHeap();
+    heapMin = heapAtBegin;
+
+    server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    server.send(code, contentType, "");
+    started = true;
+}
+
+// Fin de réponse : vide le tampon et envoie le chunk final
+void ResponseWriter::end()
+{
+    if (!started || finished)
+        return;
+
+    flushBuffer();
+    server.sendContent(""); // Chunk de taille nulle = fin de la réponse
+    finished = true;
+
+#ifdef RESPONSE_WRITER_TRACE
+    Serial.printf("[Web] %s : %u octets, %u chunks, tas utilisé %u octets\n",
+                  server.uri().c_str(), (unsigned)bytesSent, chunkCount, getHeapUsed());
+#endif
+}
+
+// Interface Print
+size_t ResponseWriter::write(uint8_t c)
+{
+    if (length >= BUFFER_SIZE)
+    {
+        flushBuffer();
+    }
+    buffer[length++] = (char)c;
+    return 1;
+}
+
+size_t ResponseWriter::write(const uint8_t *data, size_t size)
+{
+    size_t written = 0;
+    while (written < size)
+    {
+        if (length >= BUFFER_SIZE)
+        {
+            flushBuffer();
+        }
+        size_t n = BUFFER_SIZE - length;
+        if (n > size - written)
+            n = size - written;
+        memcpy(buffer + length, data + written, n);
+        length += n;
+        written += n;
+    }
+    return written;
+}
+
+// Échappement
+size_t ResponseWriter::printJSONString(const char *text)
+{
+    return printJSONString(*this, text);
+}
+
+size_t ResponseWriter::printHTMLEscaped(const char *text)
+{
+    return printHTMLEscaped(*this, text);
+}
+
+size_t ResponseWriter::printJSONString(Print &out, const char *text)
+{
+    size_t n = out.write('"');
+    if (text != nullptr)
+    {
+        for (const char *p = text; *p != '\0'; p++)
+        {
+            const uint8_t c = (uint8_t)*p;
+            switch (c)
+            {
+            case '"':
+                n += out.print(F("\\\""));
+                break;
+            case '\\':
+                n += out.print(F("\\\\"));
+                break;
+            case '\n':
+                n += out.print(F("\\n"));
+                break;
+            case '\r':
+                n += out.print(F("\\r"));
+                break;
+            case '\t':
+                n += out.print(F("\\t"));
+                break;
+            default:
+                if (c < 0x20)
+                {
+                    // Caractère de contrôle : \u00XX
+                    n += out.printf("\\u%04x", c);
+                }
+                else
+                {
+                    n += out.write(c); // UTF-8 transmis tel quel
+                }
+                break;
+            }
+        }
+    }
+    n += out.write('"');
+    return n;
+}
+
+size_t ResponseWriter::printHTMLEscaped(Print &out, const char *text)
+{
+    size_t n = 0;
+    if (text == nullptr)
+        return 0;
+
+    for (const char *p = text; *p != '\0'; p++)
+    {
+        switch (*p)
+        {
+        case '&':
+            n += out.print(F("&amp;"));
+            break;
+        case '<':
+            n += out.print(F("&lt;"));
+            break;
+        case '>':
+            n += out.print(F("&gt;"));
+            break;
+        case '"':
+            n += out.print(F("&quot;"));
+            break;
+        case '\'':
+            n += out.print(F("&#39;"));
+            break;
+        default:
+            n += out.write((uint8_t)*p);
+            break;
+        }
+    }
+    return n;
+}
+
+// Statistiques
+size_t ResponseWriter::getBytesSent() const
+{
+    return bytesSent;
+}
+
+uint16_t ResponseWriter::getChunkCount() const
+{
+    return chunkCount;
+}
+
+uint32_t ResponseWriter::getHeapUsed() const
+{
+    return heapAtBegin - heapMin;
+}
+
+// Méthodes privées
+void ResponseWriter::flushBuffer()
+{
+    if (length == 0)
+        return;
+
+    sampleHeap();
+    server.sendContent(buffer, length);
+    bytesSent += length;
+    chunkCount++;
+    length = 0;
+}
+
+void ResponseWriter::sampleHeap()
+{
+    const uint32_t freeHeap = ESP.getFreeHeap();
+    if (freeHeap < heapMin)
+    {
+        heapMin = freeHeap;
+    }
+}
+
+// -------------------- BufferPrint --------------------
+BufferPrint::BufferPrint(char *buffer, size_t size)
+{
+    this->buffer = buffer;
+    capacity = size > 0 ? size - 1 : 0;
+    reset();
+}
+
+size_t BufferPrint::write(uint8_t c)
+{
+    if (used >= capacity)
+    {
+        overflow = true;
+        return 0;
+    }
+    buffer[used++] = (char)c;
+    buffer[used] = '\0';
+    return 1;
+}
+
+size_t BufferPrint::write(const uint8_t *data, size_t size)
+{
+    size_t n = capacity - used;
+    if (size > n)
+    {
+        overflow = true;
+    }
+    else
+    {
+        n = size;
+    }
+    memcpy(buffer + used, data, n);
+    used += n;
+    buffer[used] = '\0';
+    return n;
+}
+
+void BufferPrint::reset()
+{
+    used = 0;
+    overflow = false;
+    buffer[0] = '\0';
+}
+
+const char *BufferPrint::c_str() const
+{
+    return buffer;
+}
+
+size_t BufferPrint::length() const
+{
+    return used;
+}
+
+bool BufferPrint::overflowed() const
+{
+    return overflow;
+}
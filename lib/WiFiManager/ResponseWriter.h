@@ -0,0 +1,91 @@
+/*
+ * ResponseWriter.h
+ * Écriture en flux des réponses HTTP (Transfer-Encoding: chunked)
+ * Les octets passent par un tampon fixe puis partent directement vers le client,
+ * sans aucune concaténation de String sur le tas
+ */
+
+#ifndef RESPONSE_WRITER_H
+#define RESPONSE_WRITER_H
+
+#include <Arduino.h>
+#include "WiFiManager.h" // WebServerType
+
+class ResponseWriter : public Print
+{
+public:
+    // Taille du tampon (l'objet est prévu pour vivre sur la pile du handler)
+    static const size_t BUFFER_SIZE = 256;
+
+    // Constructeur
+    ResponseWriter(WebServerType &server);
+    ~ResponseWriter(); // Termine la réponse si end() n'a pas été appelé
+
+    // Début / fin de réponse
+    void begin(int code, const char *contentType);
+    void end();
+
+    // Interface Print : tout print()/printf() passe par le tampon
+    using Print::write;
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *data, size_t size) override;
+
+    // Échappement (instance)
+    size_t printJSONString(const char *text);
+    size_t printHTMLEscaped(const char *text);
+
+    // Échappement (utilisable sur n'importe quel Print)
+    static size_t printJSONString(Print &out, const char *text); // Ajoute les guillemets
+    static size_t printHTMLEscaped(Print &out, const char *text);
+
+    // Statistiques de la réponse
+    size_t getBytesSent() const;
+    uint16_t getChunkCount() const;
+    uint32_t getHeapUsed() const; // Baisse maximale du tas observée pendant la réponse
+
+private:
+    WebServerType &server;
+
+    // Tampon fixe
+    char buffer[BUFFER_SIZE];
+    size_t length;
+
+    // État
+    bool started;
+    bool finished;
+
+    // Statistiques
+    size_t bytesSent;
+    uint16_t chunkCount;
+    uint32_t heapAtBegin;
+    uint32_t heapMin;
+
+    // Méthodes privées
+    void flushBuffer();
+    void sampleHeap();
+};
+
+// Print vers un tampon fixe fourni par l'appelant
+// Jamais réalloué : en cas de débordement, les octets en trop sont ignorés et signalés
+class BufferPrint : public Print
+{
+public:
+    BufferPrint(char *buffer, size_t size); // size >= 1 (place du '\0')
+
+    using Print::write;
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *data, size_t size) override;
+
+    void reset();
+    const char *c_str() const; // Toujours terminé par '\0'
+    size_t length() const;
+    bool overflowed() const;
+
+private:
+    char *buffer;
+    size_t capacity; // Taille utile (hors '\0')
+    size_t used;
+    bool overflow;
+};
+
+#endif // RESPONSE_WRITER_H
@@ -4,23 +4,79 @@
  */
 
 #include "WiFiManager.h"
+#include "ResponseWriter.h"
+#include "HomePage.h" // default Home Page
+#include <StreamString.h>
 
 // Constructeur
 WiFiManager::WiFiManager(const char *ssid, const char *password, const char *hostname)
 {
-    this->ssid = ssid;
-    this->password = password;
     this->hostname = hostname;
 
+    strncpy(networks[0].ssid, ssid, sizeof(networks[0].ssid) - 1);
+    networks[0].ssid[sizeof(networks[0].ssid) - 1] = '\0';
+    strncpy(networks[0].password, password != nullptr ? password : "", sizeof(networks[0].password) - 1);
+    networks[0].password[sizeof(networks[0].password) - 1] = '\0';
+    networkCount = 1;
+    candidateCount = 0;
+    candidateIndex = 0;
+    currentNetwork = 0;
+
+    roamInterval = 0;
+    roamThreshold = 12;
+    lastRoamCheck = 0;
+    roamScanPending = false;
+    attemptRoam = false;
+    roamCount = 0;
+
+    rssiHead = 0;
+    rssiCount = 0;
+    rssiSampleInterval = 10000;
+    lastRssiSample = 0;
+    linkEventHead = 0;
+    linkEventCount = 0;
+    outageOpen = false;
+    outageStart = 0;
+    outageCount = 0;
+    outageTotalMs = 0;
+    longestOutageMs = 0;
+    memset(lastBSSID, 0, sizeof(lastBSSID));
+    lastChannel = 0;
+
     webServer = nullptr;
     serverEnabled = false;
     serverPort = 80;
+    routeStatsCount = 0;
+
+    scanResultCount = 0;
+    scanRunning = false;
+    scanValid = false;
+    scanStartTime = 0;
+    scanTime = 0;
+    scanTtlMs = 60000; // 1 minute par défaut
 
     currentState = WIFI_DISCONNECTED;
     lastConnectionAttempt = 0;
     connectionTimeout = 30000; // 30 secondes par défaut
     reconnectAttempts = 0;
-    maxReconnectAttempts = 5;
+    maxReconnectAttempts = 0; // Réessayer indéfiniment
+    reconnectBaseDelay = 1000;
+    reconnectMaxDelay = 5 * 60 * 1000UL;
+    nextAttemptTime = 0;
+    retryScheduled = false;
+    fastConnectEnabled = true;
+    fastCacheValid = false;
+    fastPathFailed = false;
+    attemptFast = false;
+    useStaticIP = false;
+    lastConnectMs = 0;
+    lastConnectFast = false;
+    fastConnectMs = 0;
+    fullConnectMs = 0;
+
+    eventGotIP = false;
+    eventDisconnected = false;
+    disconnectReason = 0;
 
     onStateChange = nullptr;
 
@@ -43,6 +99,11 @@ bool WiFiManager::begin()
     WiFi.setHostname(hostname);
 #endif
 
+    WiFi.setAutoReconnect(false); // Reconnexion gérée par checkConnection() (backoff)
+    registerEvents();
+    loadNetworks();
+    loadFastCache();
+
     return true;
 }
 
@@ -56,33 +117,31 @@ void WiFiManager::setMaxReconnectAttempts(uint8_t attempts)
     maxReconnectAttempts = attempts;
 }
 
+void WiFiManager::setReconnectBackoff(unsigned long baseMs, unsigned long maxMs)
+{
+    reconnectBaseDelay = baseMs;
+    reconnectMaxDelay = maxMs;
+}
+
 // Connexion WiFi
+// Bloquante (au plus connectionTimeout) : réservée au démarrage, loop() passe par checkConnection()
 bool WiFiManager::connect()
 {
     Serial.println(F("[WiFi] Tentative de connexion..."));
-    Serial.print(F("[WiFi] SSID: "));
-    Serial.println(ssid);
-
-    updateState(WIFI_CONNECTING);
+    Serial.printf("[WiFi] %u réseau(x) connu(s)\n", networkCount);
 
-    WiFi.begin(ssid, password);
-    lastConnectionAttempt = millis();
+    reconnectAttempts = 0;
+    startAttempt();
 
     // Attente de la connexion
-    while (WiFi.status() != WL_CONNECTED &&
-           (millis() - lastConnectionAttempt < connectionTimeout))
+    while (currentState == WIFI_CONNECTING)
     {
-        delay(500);
-        Serial.print(".");
+        delay(100);
+        checkConnection();
     }
-    Serial.println();
 
-    if (WiFi.status() == WL_CONNECTED)
+    if (currentState == WIFI_CONNECTED)
     {
-        updateState(WIFI_CONNECTED);
-        reconnectAttempts = 0;
-        printConnectionStatus();
-
         // Synchroniser l'heure si NTP est activé
         if (ntpEnabled)
         {
@@ -93,12 +152,20 @@ bool WiFiManager::connect()
     }
     else
     {
-        updateState(WIFI_CONNECTION_FAILED);
         Serial.println(F("[WiFi] Échec de connexion"));
         return false;
     }
 }
 
+// Première connexion sans attendre : l'état (getState(), callback) indique l'issue.
+// Avec NTP activé, la synchro SNTP part en tâche de fond dès l'obtention de l'IP
+void WiFiManager::connectAsync()
+{
+    Serial.println(F("[WiFi] Connexion en tâche de fond..."));
+    reconnectAttempts = 0;
+    startAttempt();
+}
+
 bool WiFiManager::isConnected()
 {
     return WiFi.status() == WL_CONNECTED;
@@ -106,46 +173,266 @@ bool WiFiManager::isConnected()
 
 void WiFiManager::disconnect()
 {
+    retryScheduled = false;
     WiFi.disconnect();
     updateState(WIFI_DISCONNECTED);
     Serial.println(F("[WiFi] Déconnecté"));
 }
 
+// Nouvelle tentative immédiate, sans attendre la fin du backoff (non bloquant)
 void WiFiManager::reconnect()
 {
-    if (reconnectAttempts < maxReconnectAttempts)
+    Serial.println(F("[WiFi] Reconnexion demandée"));
+    startAttempt();
+}
+
+// Machine à états : à appeler dans loop(), ne bloque jamais
+// Les callbacks du SDK ne font que poser des drapeaux, traités ici
+void WiFiManager::checkConnection()
+{
+    pollScan(); // Le classement et le roaming dépendent du scan, même sans serveur web
+
+    if (eventGotIP)
     {
-        reconnectAttempts++;
-        Serial.print(F("[WiFi] Reconnexion (tentative "));
-        Serial.print(reconnectAttempts);
-        Serial.print("/");
-        Serial.print(maxReconnectAttempts);
-        Serial.println(")");
-        connect();
+        eventGotIP = false;
+        if (currentState != WIFI_CONNECTED && WiFi.status() == WL_CONNECTED)
+        {
+            onConnected();
+        }
     }
-    else
+
+    if (eventDisconnected)
     {
-        Serial.println(F("[WiFi] Nombre maximum de tentatives atteint"));
-        updateState(WIFI_CONNECTION_FAILED);
+        eventDisconnected = false;
+        if (currentState == WIFI_CONNECTED)
+        {
+            Serial.printf("[WiFi] Connexion perdue (raison %u)\n", disconnectReason);
+            beginOutage(disconnectReason);
+            updateState(WIFI_CONNECTION_LOST);
+            scheduleRetry();
+        }
+        else if (currentState == WIFI_CONNECTING && disconnectReason != 8) // 8 : ASSOC_LEAVE, provoqué par WiFi.begin()
+        {
+            failAttempt(); // Refus explicite (mot de passe, AP absent...) : inutile d'attendre le délai
+        }
+    }
+
+    switch (currentState)
+    {
+    case WIFI_CONNECTED:
+        if (WiFi.status() != WL_CONNECTED) // Filet de sécurité si l'événement a été manqué
+        {
+            Serial.println(F("[WiFi] Connexion perdue"));
+            beginOutage(disconnectReason);
+            updateState(WIFI_CONNECTION_LOST);
+            scheduleRetry();
+            break;
+        }
+
+        sampleLink();
+        if (roamInterval > 0 && !scanRunning && millis() - lastRoamCheck >= roamInterval)
+        {
+            lastRoamCheck = millis();
+            roamScanPending = startScan();
+        }
+        else if (roamScanPending && !scanRunning)
+        {
+            roamScanPending = false;
+            checkRoaming();
+        }
+        break;
+
+    case WIFI_CONNECTING:
+        if (millis() - lastConnectionAttempt >= ((attemptFast || attemptRoam) ? FAST_CONNECT_TIMEOUT_MS : connectionTimeout))
+        {
+            failAttempt();
+        }
+        break;
+
+    case WIFI_CONNECTION_LOST:
+    case WIFI_CONNECTION_FAILED:
+        if (retryScheduled && !scanRunning && (long)(millis() - nextAttemptTime) >= 0) // Classement à jour
+        {
+            startAttempt();
+        }
+        break;
+
+    default:
+        break;
     }
 }
 
-void WiFiManager::checkConnection()
+uint8_t WiFiManager::getReconnectAttempts() const
+{
+    return reconnectAttempts;
+}
+
+uint8_t WiFiManager::getLastDisconnectReason() const
+{
+    return disconnectReason;
+}
+
+// Réseaux connus
+bool WiFiManager::addNetwork(const char *ssid, const char *password)
 {
-    static unsigned long lastCheck = 0;
+    if (ssid == nullptr || ssid[0] == '\0')
+        return false;
 
-    // Vérifier toutes les 10 secondes
-    if (millis() - lastCheck > 10000)
+    int8_t index = findNetwork(ssid);
+    if (index == 0)
+        return true; // Réseau du constructeur : non persisté
+    if (index < 0)
+    {
+        if (networkCount >= MAX_NETWORKS)
+        {
+            Serial.println(F("[WiFi] ✗ Liste des réseaux pleine"));
+            return false;
+        }
+        index = networkCount++;
+        strncpy(networks[index].ssid, ssid, sizeof(networks[index].ssid) - 1);
+        networks[index].ssid[sizeof(networks[index].ssid) - 1] = '\0';
+    }
+    else if (strncmp(networks[index].password, password != nullptr ? password : "", sizeof(networks[index].password) - 1) == 0)
     {
-        lastCheck = millis();
+        return true; // Inchangé : pas d'écriture en flash
+    }
+
+    strncpy(networks[index].password, password != nullptr ? password : "", sizeof(networks[index].password) - 1);
+    networks[index].password[sizeof(networks[index].password) - 1] = '\0';
+    saveNetworks();
+    return true;
+}
 
-        if (WiFi.status() != WL_CONNECTED && currentState == WIFI_CONNECTED)
+bool WiFiManager::removeNetwork(const char *ssid)
+{
+    const int8_t index = findNetwork(ssid);
+    if (index <= 0)
+        return false;
+
+    for (uint8_t i = index; i + 1 < networkCount; i++)
+    {
+        networks[i] = networks[i + 1];
+    }
+    networkCount--;
+    if (currentNetwork >= networkCount)
+    {
+        currentNetwork = 0;
+    }
+    saveNetworks();
+    return true;
+}
+
+uint8_t WiFiManager::getNetworkCount() const
+{
+    return networkCount;
+}
+
+const char *WiFiManager::getNetworkSSID(uint8_t index) const
+{
+    return index < networkCount ? networks[index].ssid : "";
+}
+
+// Roaming
+void WiFiManager::setRoaming(unsigned long intervalMs, int8_t thresholdDb)
+{
+    roamInterval = intervalMs;
+    roamThreshold = thresholdDb;
+    lastRoamCheck = millis();
+}
+
+uint32_t WiFiManager::getRoamCount() const
+{
+    return roamCount;
+}
+
+// Qualité de liaison
+void WiFiManager::setLinkSampleInterval(unsigned long ms)
+{
+    rssiSampleInterval = ms;
+}
+
+uint8_t WiFiManager::getRSSIStats(int8_t &min, int8_t &median, int8_t &max) const
+{
+    min = median = max = 0;
+    if (rssiCount == 0)
+        return 0;
+
+    // Copie triée (insertion : 60 valeurs au plus, seulement à la lecture)
+    int8_t sorted[RSSI_HISTORY];
+    for (uint8_t i = 0; i < rssiCount; i++)
+    {
+        const int8_t value = rssiSamples[i];
+        uint8_t j = i;
+        while (j > 0 && sorted[j - 1] > value)
         {
-            updateState(WIFI_CONNECTION_LOST);
-            Serial.println(F("[WiFi] Connexion perdue"));
-            reconnect();
+            sorted[j] = sorted[j - 1];
+            j--;
         }
+        sorted[j] = value;
     }
+    min = sorted[0];
+    median = sorted[rssiCount / 2];
+    max = sorted[rssiCount - 1];
+    return rssiCount;
+}
+
+uint32_t WiFiManager::getOutageCount() const
+{
+    return outageCount;
+}
+
+uint32_t WiFiManager::getOutageTotalMs() const
+{
+    return outageTotalMs + (outageOpen ? millis() - outageStart : 0);
+}
+
+uint8_t WiFiManager::getLinkEventCount() const
+{
+    return linkEventCount;
+}
+
+const LinkEvent &WiFiManager::getLinkEvent(uint8_t index) const
+{
+    static const LinkEvent none = {}; // Aucun événement : time = 0
+    if (linkEventCount == 0)
+        return none;
+    if (index >= linkEventCount)
+        index = linkEventCount - 1; // Appelant hors bornes : l'événement le plus ancien
+    return linkEvents[(linkEventHead + MAX_LINK_EVENTS - 1 - index) % MAX_LINK_EVENTS];
+}
+
+// Reconnexion rapide et IP fixe
+void WiFiManager::enableFastConnect(bool enable)
+{
+    fastConnectEnabled = enable;
+}
+
+void WiFiManager::clearFastConnectCache()
+{
+    fastCacheValid = false;
+    Preferences preferences;
+    preferences.begin("wifimanager", false);
+    preferences.remove("fast");
+    preferences.end();
+}
+
+void WiFiManager::setStaticIP(IPAddress ip, IPAddress gateway, IPAddress subnet, IPAddress dns)
+{
+    useStaticIP = true;
+    staticIP = ip;
+    staticGateway = gateway;
+    staticSubnet = subnet;
+    staticDNS = dns;
+}
+
+unsigned long WiFiManager::getLastConnectTime() const
+{
+    return lastConnectMs;
+}
+
+bool WiFiManager::isLastConnectFast() const
+{
+    return lastConnectFast;
 }
 
 // Informations WiFi
@@ -185,36 +472,13 @@ WifiState WiFiManager::getState()
 
 String WiFiManager::getStateString()
 {
-    switch (currentState)
-    {
-    case WIFI_DISCONNECTED:
-        return "Déconnecté";
-    case WIFI_CONNECTING:
-        return "Connexion...";
-    case WIFI_CONNECTED:
-        return "Connecté";
-    case WIFI_CONNECTION_FAILED:
-        return "Échec";
-    case WIFI_CONNECTION_LOST:
-        return "Perdu";
-    default:
-        return "Inconnu";
-    }
+    return String(getStateLabel());
 }
 
 // Qualité du signal
 String WiFiManager::getSignalQuality()
 {
-    int rssi = getRSSI();
-    if (rssi > -50)
-        return "Excellent";
-    if (rssi > -60)
-        return "Bon";
-    if (rssi > -70)
-        return "Moyen";
-    if (rssi > -80)
-        return "Faible";
-    return "Très faible";
+    return String(getSignalLabel(getRSSI()));
 }
 
 uint8_t WiFiManager::getSignalPercent()
@@ -232,9 +496,12 @@ bool WiFiManager::startWebServer(uint16_t port)
         stopWebServer();
     }
 
-    if (!isConnected())
+    // Sur le réseau ou sur le point d'accès de secours (WIFI_AP / WIFI_AP_STA) : le serveur
+    // écoute sur toutes les interfaces, il reste joignable si le réseau arrive ensuite
+    const bool pointAcces = (WiFi.getMode() & WIFI_AP) != 0;
+    if (!isConnected() && !pointAcces)
     {
-        Serial.println(F("[Web] Impossible de démarrer: WiFi non connecté"));
+        Serial.println(F("[Web] Impossible de démarrer: WiFi non connecté, pas de point d'accès"));
         return false;
     }
 
@@ -245,7 +512,7 @@ bool WiFiManager::startWebServer(uint16_t port)
     serverEnabled = true;
 
     Serial.print(F("[Web] Serveur démarré sur http://"));
-    Serial.print(getIP());
+    Serial.print(isConnected() ? getIP() : WiFi.softAPIP().toString());
     Serial.print(":");
     Serial.println(serverPort);
 
@@ -270,6 +537,7 @@ void WiFiManager::handleClient()
     {
         webServer->handleClient();
     }
+    pollScan();
 }
 
 WebServerType *WiFiManager::getServer()
@@ -282,8 +550,12 @@ void WiFiManager::on(const char *uri, WebHandler handler)
 {
     if (webServer != nullptr)
     {
-        webServer->on(uri, [this, handler]()
-                      { handler(*webServer); });
+        RouteStats *stats = addRouteStats(uri);
+        webServer->on(uri, [this, handler, stats]()
+                      {
+                          const unsigned long start = micros();
+                          handler(*webServer);
+                          recordRoute(stats, start); });
     }
 }
 
@@ -291,8 +563,12 @@ void WiFiManager::on(const char *uri, HTTPMethod method, WebHandler handler)
 {
     if (webServer != nullptr)
     {
-        webServer->on(uri, method, [this, handler]()
-                      { handler(*webServer); });
+        RouteStats *stats = addRouteStats(uri);
+        webServer->on(uri, method, [this, handler, stats]()
+                      {
+                          const unsigned long start = micros();
+                          handler(*webServer);
+                          recordRoute(stats, start); });
     }
 }
 
@@ -300,9 +576,53 @@ void WiFiManager::onNotFound(WebHandler handler)
 {
     if (webServer != nullptr)
     {
-        webServer->onNotFound([this, handler]()
-                              { handler(*webServer); });
+        RouteStats *stats = addRouteStats("notFound");
+        webServer->onNotFound([this, handler, stats]()
+                              {
+                                  const unsigned long start = micros();
+                                  handler(*webServer);
+                                  recordRoute(stats, start); });
+    }
+}
+
+uint8_t WiFiManager::getRouteStatsCount() const
+{
+    return routeStatsCount;
+}
+
+const RouteStats &WiFiManager::getRouteStats(uint8_t index) const
+{
+    return routeStats[index < routeStatsCount ? index : 0];
+}
+
+RouteStats *WiFiManager::addRouteStats(const char *uri)
+{
+    for (uint8_t i = 0; i < routeStatsCount; i++)
+    {
+        if (strcmp(routeStats[i].uri, uri) == 0)
+            return &routeStats[i];
     }
+    if (routeStatsCount >= MAX_ROUTE_STATS)
+        return nullptr; // Route servie normalement, sans statistiques
+
+    RouteStats *stats = &routeStats[routeStatsCount++];
+    stats->uri = uri;
+    stats->count = 0;
+    stats->totalUs = 0;
+    stats->maxUs = 0;
+    return stats;
+}
+
+void WiFiManager::recordRoute(RouteStats *stats, unsigned long startUs)
+{
+    if (stats == nullptr)
+        return;
+
+    const uint32_t duration = micros() - startUs;
+    stats->count++;
+    stats->totalUs += duration;
+    if (duration > stats->maxUs)
+        stats->maxUs = duration;
 }
 
 void WiFiManager::serveStatic(const char *uri, const char *contentType, const char *content)
@@ -320,71 +640,160 @@ void WiFiManager::enableDefaultPages(bool enable)
     if (!enable || webServer == nullptr)
         return;
 
-    // Default Home Page
-    webServer->on("/", [this]()
-                  { webServer->send(200, "text/html", getDefaultHTML()); });
+    // Default Home Page (PROGMEM, sans copie en RAM)
+    RouteStats *stats = addRouteStats("/");
+    webServer->on("/", [this, stats]()
+                  {
+                      const unsigned long start = micros();
+                      webServer->send_P(200, PSTR("text/html"), HomePage::getHTML());
+                      recordRoute(stats, start); });
 
     // Page de statut JSON
-    webServer->on("/status", [this]()
-                  { webServer->send(200, "application/json", getStatusJSON()); });
+    stats = addRouteStats("/status");
+    webServer->on("/status", [this, stats]()
+                  {
+                      const unsigned long start = micros();
+                      ResponseWriter out(*webServer);
+                      out.begin(200, "application/json");
+                      writeStatusJSON(out);
+                      out.end();
+                      recordRoute(stats, start); });
 
     // Page de statut HTML
-    webServer->on("/info", [this]()
-                  { webServer->send(200, "text/html", getStatusHTML()); });
+    stats = addRouteStats("/info");
+    webServer->on("/info", [this, stats]()
+                  {
+                      const unsigned long start = micros();
+                      ResponseWriter out(*webServer);
+                      out.begin(200, "text/html");
+                      writeStatusHTML(out);
+                      out.end();
+                      recordRoute(stats, start); });
 }
 
 String WiFiManager::getDefaultHTML()
 {
-    return HomePage::getHTML();
+    return String(FPSTR(HomePage::getHTML()));
 }
 
 String WiFiManager::getStatusJSON()
 {
-    String json = "{";
-    json += "\"ssid\":\"" + getSSID() + "\",";
-    json += "\"ip\":\"" + getIP() + "\",";
-    json += "\"mac\":\"" + getMAC() + "\",";
-    json += "\"rssi\":" + String(getRSSI()) + ",";
-    json += "\"signal\":\"" + getSignalQuality() + "\",";
-    json += "\"hostname\":\"" + getHostname() + "\",";
-    json += "\"state\":\"" + getStateString() + "\"";
+    StreamString json;
+    writeStatusJSON(json);
+    return json;
+}
+
+String WiFiManager::getStatusHTML()
+{
+    StreamString html;
+    writeStatusHTML(html);
+    return html;
+}
+
+void WiFiManager::writeStatusJSON(Print &out)
+{
+    char timeBuf[32];
+
+    out.print(F("{\"ssid\":"));
+    ResponseWriter::printJSONString(out, networks[currentNetwork].ssid);
+    out.print(F(",\"ip\":\""));
+    out.print(WiFi.localIP());
+    out.print(F("\",\"mac\":\""));
+    printMAC(out);
+    out.print(F("\",\"rssi\":"));
+    out.print(getRSSI());
+    out.print(F(",\"signal\":"));
+    ResponseWriter::printJSONString(out, getSignalLabel(getRSSI()));
+    out.print(F(",\"hostname\":"));
+    ResponseWriter::printJSONString(out, hostname);
+    out.print(F(",\"state\":"));
+    ResponseWriter::printJSONString(out, getStateLabel());
+    out.print(F(",\"connect\":{\"path\":"));
+    out.print(lastConnectFast ? F("\"fast\"") : F("\"full\""));
+    out.print(F(",\"ms\":"));
+    out.print(lastConnectMs);
+    out.print(F(",\"fastMs\":"));
+    out.print(fastConnectMs);
+    out.print(F(",\"fullMs\":"));
+    out.print(fullConnectMs);
+    out.print(F(",\"staticIP\":"));
+    out.print(useStaticIP ? F("true") : F("false"));
+    out.print(F(",\"networks\":"));
+    out.print(networkCount);
+    out.print(F(",\"roams\":"));
+    out.print(roamCount);
+    out.print(F("},\"link\":"));
+    writeLinkJSON(out);
 
     if (ntpEnabled)
     {
-        json += ",\"time\":\"" + getTime() + "\",";
-        json += "\"date\":\"" + getDate() + "\"";
+        formatTime(timeBuf, sizeof(timeBuf), "%H:%M:%S");
+        out.print(F(",\"time\":\""));
+        out.print(timeBuf);
+        formatTime(timeBuf, sizeof(timeBuf), "%d/%m/%Y");
+        out.print(F("\",\"date\":\""));
+        out.print(timeBuf);
+        out.print('"');
     }
 
-    json += "}";
-    return json;
+    out.print('}');
 }
 
-String WiFiManager::getStatusHTML()
+void WiFiManager::writeStatusHTML(Print &out)
 {
-    String html = "<!DOCTYPE html><html><head>";
-    html += "<meta charset='UTF-8'><title>WiFi Status</title>";
-    html += "<style>body{font-family:Arial;margin:20px;}";
-    html += "table{border-collapse:collapse;width:100%;max-width:600px;}";
-    html += "td,th{border:1px solid #ddd;padding:8px;text-align:left;}";
-    html += "th{background-color:#4CAF50;color:white;}</style></head><body>";
-    html += "<h1>Statut WiFi</h1><table>";
-    html += "<tr><th>Paramètre</th><th>Valeur</th></tr>";
-    html += "<tr><td>État</td><td>" + getStateString() + "</td></tr>";
-    html += "<tr><td>SSID</td><td>" + getSSID() + "</td></tr>";
-    html += "<tr><td>IP</td><td>" + getIP() + "</td></tr>";
-    html += "<tr><td>MAC</td><td>" + getMAC() + "</td></tr>";
-    html += "<tr><td>Hostname</td><td>" + getHostname() + "</td></tr>";
-    html += "<tr><td>RSSI</td><td>" + String(getRSSI()) + " dBm</td></tr>";
-    html += "<tr><td>Signal</td><td>" + getSignalQuality() + " (" + String(getSignalPercent()) + "%)</td></tr>";
+    char timeBuf[32];
+    const int rssi = getRSSI();
+
+    out.print(F("<!DOCTYPE html><html><head>"
+                "<meta charset='UTF-8'><title>WiFi Status</title>"
+                "<style>body{font-family:Arial;margin:20px;}"
+                "table{border-collapse:collapse;width:100%;max-width:600px;}"
+                "td,th{border:1px solid #ddd;padding:8px;text-align:left;}"
+                "th{background-color:#4CAF50;color:white;}</style></head><body>"
+                "<h1>Statut WiFi</h1><table>"
+                "<tr><th>Paramètre</th><th>Valeur</th></tr>"));
+    out.print(F("<tr><td>État</td><td>"));
+    out.print(getStateLabel());
+    out.print(F("</td></tr><tr><td>SSID</td><td>"));
+    ResponseWriter::printHTMLEscaped(out, networks[currentNetwork].ssid);
+    out.print(F("</td></tr><tr><td>IP</td><td>"));
+    out.print(WiFi.localIP());
+    out.print(F("</td></tr><tr><td>MAC</td><td>"));
+    printMAC(out);
+    out.print(F("</td></tr><tr><td>Hostname</td><td>"));
+    ResponseWriter::printHTMLEscaped(out, hostname);
+    out.print(F("</td></tr><tr><td>RSSI</td><td>"));
+    out.print(rssi);
+    out.print(F(" dBm</td></tr><tr><td>Signal</td><td>"));
+    out.print(getSignalLabel(rssi));
+    out.print(F(" ("));
+    out.print(getSignalPercent());
+    out.print(F("%)</td></tr>"));
+
+    int8_t rssiMin, rssiMedian, rssiMax;
+    if (getRSSIStats(rssiMin, rssiMedian, rssiMax) > 0)
+    {
+        out.print(F("<tr><td>RSSI min / médiane / max</td><td>"));
+        out.printf("%d / %d / %d dBm</td></tr>", rssiMin, rssiMedian, rssiMax);
+    }
+    out.print(F("<tr><td>Coupures</td><td>"));
+    out.print(outageCount);
+    out.print(F(" ("));
+    out.print(getOutageTotalMs() / 1000);
+    out.print(F(" s)</td></tr>"));
 
     if (ntpEnabled)
     {
-        html += "<tr><td>Heure</td><td>" + getTime() + "</td></tr>";
-        html += "<tr><td>Date</td><td>" + getDate() + "</td></tr>";
+        formatTime(timeBuf, sizeof(timeBuf), "%H:%M:%S");
+        out.print(F("<tr><td>Heure</td><td>"));
+        out.print(timeBuf);
+        formatTime(timeBuf, sizeof(timeBuf), "%d/%m/%Y");
+        out.print(F("</td></tr><tr><td>Date</td><td>"));
+        out.print(timeBuf);
+        out.print(F("</td></tr>"));
     }
 
-    html += "</table></body></html>";
-    return html;
+    out.print(F("</table></body></html>"));
 }
 
 // NTP
@@ -442,10 +851,8 @@ bool WiFiManager::syncTime()
 
 String WiFiManager::getTime(const char *format)
 {
-    time_t now = time(nullptr);
-    struct tm *timeinfo = localtime(&now);
     char buffer[32];
-    strftime(buffer, sizeof(buffer), format, timeinfo);
+    formatTime(buffer, sizeof(buffer), format);
     return String(buffer);
 }
 
@@ -542,60 +949,626 @@ void WiFiManager::enableAutoReconnect(bool enable)
 int WiFiManager::scanNetworks()
 {
     Serial.println(F("[WiFi] Scan des réseaux..."));
+    scanRunning = false;
     int n = WiFi.scanNetworks();
+    storeScanResults(n);
     Serial.print(n);
     Serial.println(F(" réseau(x) trouvé(s)"));
     return n;
 }
 
+bool WiFiManager::startScan()
+{
+    if (scanRunning)
+    {
+        return false;
+    }
+    Serial.println(F("[WiFi] Scan des réseaux (asynchrone)..."));
+    WiFi.scanNetworks(true); // Rend la main tout de suite, suivi par pollScan()
+    scanRunning = true;
+    scanStartTime = millis();
+    return true;
+}
+
+bool WiFiManager::isScanning() const
+{
+    return scanRunning;
+}
+
+bool WiFiManager::isScanFresh() const
+{
+    return scanValid && getScanAge() < scanTtlMs;
+}
+
+unsigned long WiFiManager::getScanAge() const
+{
+    return millis() - scanTime;
+}
+
+void WiFiManager::setScanTTL(unsigned long ttlMs)
+{
+    scanTtlMs = ttlMs;
+}
+
+uint8_t WiFiManager::getScanResultCount() const
+{
+    return scanResultCount;
+}
+
+const ScanResult &WiFiManager::getScanResult(uint8_t index) const
+{
+    return scanResults[index < scanResultCount ? index : 0];
+}
+
 String WiFiManager::getScannedNetwork(int index)
 {
-    if (index < 0 || index >= WiFi.scanComplete())
+    if (index < 0 || index >= scanResultCount)
         return "";
 
-    String info = WiFi.SSID(index);
+    const ScanResult &network = scanResults[index];
+    String info = network.ssid;
     info += " (";
-    info += WiFi.RSSI(index);
+    info += network.rssi;
     info += " dBm)";
-    info += (WiFi.encryptionType(index) ==
-#ifdef ESP8266
-             ENC_TYPE_NONE
-#else
-             WIFI_AUTH_OPEN
-#endif
-             )
-                ? " "
-                : "*";
+    info += network.encrypted ? "*" : " ";
 
     return info;
 }
 
 String WiFiManager::getScannedNetworkJSON()
 {
-    int n = WiFi.scanComplete();
-    String json = "{\"networks\":[";
+    StreamString json;
+    writeScannedNetworkJSON(json);
+    return json;
+}
 
-    for (int i = 0; i < n; i++)
+void WiFiManager::writeScannedNetworkJSON(Print &out)
+{
+    out.print(F("{\"scanning\":"));
+    out.print(scanRunning ? F("true") : F("false"));
+    out.print(F(",\"age\":"));
+    if (scanValid)
     {
+        out.print(getScanAge() / 1000);
+    }
+    else
+    {
+        out.print(F("null"));
+    }
+    out.print(F(",\"networks\":["));
+
+    for (uint8_t i = 0; i < scanResultCount; i++)
+    {
+        const ScanResult &network = scanResults[i];
         if (i > 0)
-            json += ",";
-        json += "{\"ssid\":\"" + WiFi.SSID(i) + "\",";
-        json += "\"rssi\":" + String(WiFi.RSSI(i)) + ",";
-        json += "\"encrypted\":" + String(WiFi.encryptionType(i) !=
+            out.print(',');
+        out.print(F("{\"ssid\":"));
+        ResponseWriter::printJSONString(out, network.ssid);
+        out.print(F(",\"rssi\":"));
+        out.print(network.rssi);
+        out.print(F(",\"channel\":"));
+        out.print(network.channel);
+        out.print(F(",\"encrypted\":"));
+        out.print(network.encrypted ? 1 : 0);
+        out.print('}');
+    }
+
+    out.print(F("]}"));
+}
+
+// Méthodes privées
+
+// Fin du scan asynchrone : copie des résultats dans le cache
+void WiFiManager::pollScan()
+{
+    if (!scanRunning)
+        return;
+
+    const int n = WiFi.scanComplete();
+    if (n >= 0)
+    {
+        scanRunning = false;
+        storeScanResults(n);
+        Serial.printf("[WiFi] Scan terminé : %d réseau(x) en %lu ms\n", n, millis() - scanStartTime);
+    }
+    else if (n != WIFI_SCAN_RUNNING || millis() - scanStartTime > 10000)
+    {
+        scanRunning = false; // Échec ou scan jamais terminé : le cache précédent est conservé
+        WiFi.scanDelete();
+        Serial.println(F("[WiFi] ✗ Échec du scan"));
+    }
+}
+
+// Copie des n résultats du SDK, triés par puissance décroissante, puis libération
+void WiFiManager::storeScanResults(int count)
+{
+    if (count < 0)
+    {
+        WiFi.scanDelete(); // Échec : le cache précédent est conservé
+        return;
+    }
+
+    scanResultCount = 0;
+    for (int i = 0; i < count; i++)
+    {
+        const int8_t rssi = WiFi.RSSI(i);
+
+        // Position dans la liste triée, les plus faibles sortent si elle est pleine
+        uint8_t position = scanResultCount;
+        while (position > 0 && scanResults[position - 1].rssi < rssi)
+        {
+            position--;
+        }
+        if (position >= MAX_SCAN_RESULTS)
+        {
+            continue;
+        }
+        const uint8_t last = scanResultCount < MAX_SCAN_RESULTS ? scanResultCount : MAX_SCAN_RESULTS - 1;
+        for (uint8_t j = last; j > position; j--)
+        {
+            scanResults[j] = scanResults[j - 1];
+        }
+
+        ScanResult &network = scanResults[position];
+        strncpy(network.ssid, WiFi.SSID(i).c_str(), sizeof(network.ssid) - 1);
+        network.ssid[sizeof(network.ssid) - 1] = '\0';
+        memcpy(network.bssid, WiFi.BSSID(i), sizeof(network.bssid));
+        network.rssi = rssi;
+        network.channel = WiFi.channel(i);
+        network.encrypted = WiFi.encryptionType(i) !=
 #ifdef ESP8266
-                                          ENC_TYPE_NONE
+                            ENC_TYPE_NONE;
 #else
-                                          WIFI_AUTH_OPEN
+                            WIFI_AUTH_OPEN;
 #endif
-                                          ) +
-                "}";
+        if (scanResultCount < MAX_SCAN_RESULTS)
+        {
+            scanResultCount++;
+        }
     }
 
-    json += "]}";
-    return json;
+    WiFi.scanDelete();
+    scanValid = true;
+    scanTime = millis();
+}
+
+void WiFiManager::registerEvents()
+{
+#ifdef ESP8266
+    gotIPHandler = WiFi.onStationModeGotIP([this](const WiFiEventStationModeGotIP &)
+                                           { eventGotIP = true; });
+    disconnectedHandler = WiFi.onStationModeDisconnected([this](const WiFiEventStationModeDisconnected &event)
+                                                         {
+                                                             disconnectReason = event.reason;
+                                                             eventDisconnected = true; });
+#else // ESP32
+    WiFi.onEvent([this](WiFiEvent_t event, WiFiEventInfo_t info)
+                 {
+                     if (event == ARDUINO_EVENT_WIFI_STA_GOT_IP)
+                     {
+                         eventGotIP = true;
+                     }
+                     else if (event == ARDUINO_EVENT_WIFI_STA_DISCONNECTED)
+                     {
+                         disconnectReason = info.wifi_sta_disconnected.reason;
+                         eventDisconnected = true;
+                     } });
+#endif
+}
+
+// Une tentative par appel. Nouveau cycle : chemin rapide si une connexion précédente est connue
+// (BSSID et canal imposés, DHCP à chaque association), puis chaque réseau connu du plus fort au plus faible
+void WiFiManager::startAttempt(bool newCycle)
+{
+    retryScheduled = false;
+    attemptRoam = false;
+    if (newCycle)
+    {
+        rankCandidates();
+        candidateIndex = 0;
+    }
+    const int8_t fastNetwork = fastCacheValid ? findNetwork(fastCache.ssid) : -1;
+    attemptFast = newCycle && fastConnectEnabled && !fastPathFailed && fastNetwork >= 0;
+    updateState(WIFI_CONNECTING);
+
+    if (attemptFast)
+    {
+        currentNetwork = fastNetwork;
+        applyIPConfig();
+        Serial.print(F("[WiFi] Connexion rapide à "));
+        Serial.println(networks[currentNetwork].ssid);
+        WiFi.begin(networks[currentNetwork].ssid, networks[currentNetwork].password, fastCache.channel, fastCache.bssid);
+    }
+    else
+    {
+        currentNetwork = candidates[candidateIndex];
+        applyIPConfig();
+        Serial.printf("[WiFi] Connexion (%u/%u) à ", candidateIndex + 1, candidateCount);
+        Serial.println(networks[currentNetwork].ssid);
+
+        // AP le plus fort de ce réseau au dernier scan (répéteurs : même SSID, plusieurs BSSID)
+        const ScanResult *ap = findBestScan(currentNetwork);
+        if (ap != nullptr)
+        {
+            WiFi.begin(networks[currentNetwork].ssid, networks[currentNetwork].password, ap->channel, ap->bssid);
+        }
+        else
+        {
+            WiFi.begin(networks[currentNetwork].ssid, networks[currentNetwork].password);
+        }
+    }
+    lastConnectionAttempt = millis();
+}
+
+void WiFiManager::failAttempt()
+{
+    if (attemptFast || attemptRoam)
+    {
+        // AP déplacé ou canal changé : repli immédiat sur les réseaux classés
+        Serial.println(attemptFast ? F("[WiFi] ✗ Connexion rapide en échec") : F("[WiFi] ✗ Roaming en échec"));
+        fastPathFailed = fastPathFailed || attemptFast;
+        startAttempt(attemptRoam);
+        return;
+    }
+
+    // Réseau suivant dans le même cycle, sans attendre
+    if (++candidateIndex < candidateCount)
+    {
+        startAttempt(false);
+        return;
+    }
+
+    // Cycle épuisé : backoff, et nouveau scan pour reclasser les réseaux avant le prochain cycle
+    startScan();
+    if (reconnectAttempts < 255)
+    {
+        reconnectAttempts++; // Saturé : en mode illimité, le backoff reste au plafond pendant une longue coupure
+    }
+    updateState(WIFI_CONNECTION_FAILED);
+    if (maxReconnectAttempts > 0 && reconnectAttempts >= maxReconnectAttempts)
+    {
+        Serial.println(F("[WiFi] Nombre maximum de tentatives atteint"));
+        retryScheduled = false;
+        WiFi.disconnect();
+        return;
+    }
+    scheduleRetry();
+}
+
+// Backoff exponentiel (base * 2^tentatives, plafonné) avec gigue : la moitié du délai est aléatoire
+void WiFiManager::scheduleRetry()
+{
+    unsigned long delayMs = reconnectMaxDelay;
+    if (reconnectAttempts < 16 && (reconnectBaseDelay << reconnectAttempts) < reconnectMaxDelay)
+    {
+        delayMs = reconnectBaseDelay << reconnectAttempts;
+    }
+    delayMs = delayMs / 2 + random(delayMs / 2 + 1);
+
+    nextAttemptTime = millis() + delayMs;
+    retryScheduled = true;
+    Serial.printf("[WiFi] Nouvelle tentative dans %lu ms\n", delayMs);
+}
+
+// IP fixe configurée, sinon DHCP à chaque association : un bail réutilisé comme IP fixe
+// ne serait jamais renouvelé, et le routeur finirait par attribuer l'adresse à un autre appareil
+void WiFiManager::applyIPConfig()
+{
+    if (useStaticIP)
+    {
+        WiFi.config(staticIP, staticGateway, staticSubnet, staticDNS);
+    }
+    else
+    {
+        WiFi.config(IPAddress((uint32_t)0), IPAddress((uint32_t)0), IPAddress((uint32_t)0)); // DHCP
+    }
+}
+
+// Ordre d'essai : réseaux vus au dernier scan (récent) par RSSI décroissant, puis les autres
+// (SSID caché, hors de portée au moment du scan) dans l'ordre de la liste
+void WiFiManager::rankCandidates()
+{
+    candidateCount = 0;
+    bool ranked[MAX_NETWORKS] = {false};
+
+    if (scanValid && getScanAge() < RANKING_MAX_AGE_MS)
+    {
+        for (uint8_t i = 0; i < scanResultCount; i++) // scanResults est déjà trié
+        {
+            const int8_t network = findNetwork(scanResults[i].ssid);
+            if (network >= 0 && !ranked[network])
+            {
+                ranked[network] = true;
+                candidates[candidateCount++] = network;
+            }
+        }
+    }
+    for (uint8_t network = 0; network < networkCount; network++)
+    {
+        if (!ranked[network])
+        {
+            candidates[candidateCount++] = network;
+        }
+    }
+}
+
+int8_t WiFiManager::findNetwork(const char *ssid) const
+{
+    for (uint8_t i = 0; i < networkCount; i++)
+    {
+        if (strcmp(networks[i].ssid, ssid) == 0)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+const ScanResult *WiFiManager::findBestScan(uint8_t network) const
+{
+    if (!scanValid || getScanAge() >= RANKING_MAX_AGE_MS)
+        return nullptr;
+
+    for (uint8_t i = 0; i < scanResultCount; i++)
+    {
+        if (strcmp(scanResults[i].ssid, networks[network].ssid) == 0)
+        {
+            return &scanResults[i]; // Le premier est le plus fort
+        }
+    }
+    return nullptr;
+}
+
+// Après un scan de roaming : AP connu (autre que l'actuel) plus fort d'au moins roamThreshold dB
+void WiFiManager::checkRoaming()
+{
+    const int rssi = WiFi.RSSI();
+    const uint8_t *bssid = WiFi.BSSID();
+    for (uint8_t i = 0; i < scanResultCount; i++)
+    {
+        const int8_t network = findNetwork(scanResults[i].ssid);
+        if (network < 0 || (bssid != nullptr && memcmp(scanResults[i].bssid, bssid, 6) == 0))
+        {
+            continue;
+        }
+        // Premier AP connu = le plus fort : les suivants ne feront pas mieux
+        if (scanResults[i].rssi >= rssi + roamThreshold)
+        {
+            Serial.printf("[WiFi] Roaming : %d dBm -> %d dBm\n", rssi, scanResults[i].rssi);
+            roamTo(network, scanResults[i]);
+        }
+        return;
+    }
+}
+
+// Réassociation ciblée sur un BSSID (sans scan). Le DHCP reste actif : sur le même réseau,
+// le routeur rend en général la même IP
+void WiFiManager::roamTo(uint8_t network, const ScanResult &ap)
+{
+    retryScheduled = false;
+    attemptFast = false;
+    attemptRoam = true;
+    roamCount++;
+    beginOutage(0); // Coupure volontaire, mesurée comme les autres
+    currentNetwork = network;
+    updateState(WIFI_CONNECTING);
+    applyIPConfig();
+    WiFi.begin(networks[network].ssid, networks[network].password, ap.channel, ap.bssid);
+    lastConnectionAttempt = millis();
+}
+
+void WiFiManager::loadNetworks()
+{
+    Preferences preferences;
+    preferences.begin("wifimanager", true);
+    const size_t length = preferences.getBytesLength("nets");
+    uint8_t count = length / sizeof(WiFiNetwork);
+    if (length % sizeof(WiFiNetwork) != 0 || count > MAX_NETWORKS - 1)
+    {
+        count = 0; // Format inattendu : ignoré
+    }
+    if (count > 0)
+    {
+        preferences.getBytes("nets", &networks[1], count * sizeof(WiFiNetwork));
+    }
+    preferences.end();
+
+    // Le réseau du constructeur reste prioritaire s'il figure aussi dans la liste
+    networkCount = 1;
+    for (uint8_t i = 1; i <= count; i++)
+    {
+        if (strcmp(networks[i].ssid, networks[0].ssid) != 0)
+        {
+            networks[networkCount++] = networks[i];
+        }
+    }
+}
+
+void WiFiManager::saveNetworks()
+{
+    Preferences preferences;
+    preferences.begin("wifimanager", false);
+    if (networkCount > 1)
+    {
+        preferences.putBytes("nets", &networks[1], (networkCount - 1) * sizeof(WiFiNetwork));
+    }
+    else
+    {
+        preferences.remove("nets");
+    }
+    preferences.end();
+}
+
+// Échantillon RSSI à cadence lente (appelé uniquement lorsque connecté)
+void WiFiManager::sampleLink()
+{
+    if (rssiCount > 0 && millis() - lastRssiSample < rssiSampleInterval)
+        return;
+
+    lastRssiSample = millis();
+    rssiSamples[rssiHead] = (int8_t)WiFi.RSSI();
+    rssiHead = (rssiHead + 1) % RSSI_HISTORY;
+    if (rssiCount < RSSI_HISTORY)
+    {
+        rssiCount++;
+    }
+}
+
+// Début de coupure : une seule coupure comptée jusqu'à la reconnexion
+void WiFiManager::beginOutage(uint8_t reason)
+{
+    if (!outageOpen)
+    {
+        outageOpen = true;
+        outageStart = millis();
+        outageCount++;
+    }
+    recordLinkEvent(LINK_DOWN, reason, 0);
+}
+
+void WiFiManager::recordLinkEvent(LinkEventType type, uint8_t reason, uint32_t durationMs)
+{
+    LinkEvent &event = linkEvents[linkEventHead];
+    linkEventHead = (linkEventHead + 1) % MAX_LINK_EVENTS;
+    if (linkEventCount < MAX_LINK_EVENTS)
+    {
+        linkEventCount++;
+    }
+
+    event.time = millis();
+    event.durationMs = durationMs;
+    event.type = type;
+    event.reason = reason;
+    if (type == LINK_DOWN)
+    {
+        // AP perdu et dernier RSSI connu : la liaison n'est déjà plus interrogeable
+        memcpy(event.bssid, lastBSSID, sizeof(event.bssid));
+        event.channel = lastChannel;
+        event.rssi = rssiCount > 0 ? rssiSamples[(rssiHead + RSSI_HISTORY - 1) % RSSI_HISTORY] : 0;
+    }
+    else
+    {
+        memcpy(event.bssid, WiFi.BSSID(), sizeof(event.bssid));
+        event.channel = WiFi.channel();
+        event.rssi = (int8_t)WiFi.RSSI();
+    }
+}
+
+void WiFiManager::writeLinkJSON(Print &out)
+{
+    static const char *const types[] = {"down", "up", "ap"};
+    int8_t rssiMin, rssiMedian, rssiMax;
+    const uint8_t samples = getRSSIStats(rssiMin, rssiMedian, rssiMax);
+
+    if (samples > 0)
+    {
+        out.printf("{\"rssi\":{\"min\":%d,\"median\":%d,\"max\":%d,", rssiMin, rssiMedian, rssiMax);
+    }
+    else
+    {
+        out.print(F("{\"rssi\":{\"min\":null,\"median\":null,\"max\":null,"));
+    }
+    out.printf("\"samples\":%u,\"intervalMs\":%lu}", samples, rssiSampleInterval);
+    out.printf(",\"outages\":%lu,\"outageMs\":%lu", (unsigned long)outageCount, (unsigned long)getOutageTotalMs());
+    out.printf(",\"longestMs\":%lu,\"down\":%s", (unsigned long)longestOutageMs, outageOpen ? "true" : "false");
+
+    out.print(F(",\"events\":["));
+    const unsigned long now = millis();
+    for (uint8_t i = 0; i < linkEventCount; i++)
+    {
+        const LinkEvent &event = getLinkEvent(i);
+        if (i > 0)
+        {
+            out.print(',');
+        }
+        out.printf("{\"age\":%lu,\"type\":\"%s\",\"reason\":%u", now - event.time, types[event.type], event.reason);
+        out.printf(",\"ms\":%lu,\"channel\":%u,\"rssi\":%d,\"bssid\":\"", (unsigned long)event.durationMs, event.channel, event.rssi);
+        printBSSID(out, event.bssid);
+        out.print(F("\"}"));
+    }
+    out.print(F("]}"));
+}
+
+void WiFiManager::onConnected()
+{
+    lastConnectMs = millis() - lastConnectionAttempt;
+    lastConnectFast = attemptFast;
+    if (attemptFast)
+    {
+        fastConnectMs = lastConnectMs;
+    }
+    else
+    {
+        fullConnectMs = lastConnectMs;
+    }
+
+    // Historique de liaison : durée de la coupure et changement d'AP
+    uint32_t outageMs = 0;
+    if (outageOpen)
+    {
+        outageOpen = false;
+        outageMs = millis() - outageStart;
+        outageTotalMs += outageMs;
+        if (outageMs > longestOutageMs)
+        {
+            longestOutageMs = outageMs;
+        }
+    }
+    recordLinkEvent(LINK_UP, 0, outageMs);
+    const uint8_t *bssid = WiFi.BSSID();
+    if (lastChannel != 0 && (WiFi.channel() != lastChannel || memcmp(bssid, lastBSSID, sizeof(lastBSSID)) != 0))
+    {
+        recordLinkEvent(LINK_AP_CHANGE, 0, 0);
+    }
+    memcpy(lastBSSID, bssid, sizeof(lastBSSID));
+    lastChannel = WiFi.channel();
+    lastRssiSample = millis() - rssiSampleInterval; // Premier échantillon dès la prochaine vérification
+
+    updateState(WIFI_CONNECTED);
+    reconnectAttempts = 0;
+    retryScheduled = false;
+    fastPathFailed = false;
+    printConnectionStatus();
+    Serial.printf("[WiFi] Connecté en %lu ms (%s)\n", lastConnectMs, attemptFast ? "rapide" : "complet");
+    saveFastCache();
+
+    if (ntpEnabled)
+    {
+        configTime(gmtOffsetSec, daylightOffsetSec, ntpServer); // Synchro SNTP en tâche de fond
+    }
+}
+
+void WiFiManager::loadFastCache()
+{
+    Preferences preferences;
+    preferences.begin("wifimanager", true);
+    fastCacheValid = preferences.getBytes("fast", &fastCache, sizeof(fastCache)) == sizeof(fastCache);
+    preferences.end();
+}
+
+// Écriture en flash seulement si quelque chose a changé (usure)
+void WiFiManager::saveFastCache()
+{
+    FastConnectCache current;
+    memset(&current, 0, sizeof(current)); // Octets de bourrage comparés par memcmp()
+    strncpy(current.ssid, networks[currentNetwork].ssid, sizeof(current.ssid) - 1);
+    memcpy(current.bssid, WiFi.BSSID(), sizeof(current.bssid));
+    current.channel = WiFi.channel();
+
+    if (fastCacheValid && memcmp(&current, &fastCache, sizeof(current)) == 0)
+    {
+        return;
+    }
+
+    fastCache = current;
+    fastCacheValid = true;
+    Preferences preferences;
+    preferences.begin("wifimanager", false);
+    preferences.putBytes("fast", &fastCache, sizeof(fastCache));
+    preferences.end();
+    Serial.println(F("[WiFi] Paramètres de connexion rapide mémorisés"));
 }
 
-// Méthodes privées
 void WiFiManager::updateState(WifiState newState)
 {
     if (currentState != newState)
@@ -624,4 +1597,55 @@ void WiFiManager::printConnectionStatus()
     Serial.print(" dBm (");
     Serial.print(getSignalQuality());
     Serial.println(")");
+}
+
+size_t WiFiManager::formatTime(char *buffer, size_t size, const char *format)
+{
+    time_t now = time(nullptr);
+    struct tm *timeinfo = localtime(&now);
+    return strftime(buffer, size, format, timeinfo);
+}
+
+const char *WiFiManager::getStateLabel()
+{
+    switch (currentState)
+    {
+    case WIFI_DISCONNECTED:
+        return "Déconnecté";
+    case WIFI_CONNECTING:
+        return "Connexion...";
+    case WIFI_CONNECTED:
+        return "Connecté";
+    case WIFI_CONNECTION_FAILED:
+        return "Échec";
+    case WIFI_CONNECTION_LOST:
+        return "Perdu";
+    default:
+        return "Inconnu";
+    }
+}
+
+const char *WiFiManager::getSignalLabel(int rssi)
+{
+    if (rssi > -50)
+        return "Excellent";
+    if (rssi > -60)
+        return "Bon";
+    if (rssi > -70)
+        return "Moyen";
+    if (rssi > -80)
+        return "Faible";
+    return "Très faible";
+}
+
+void WiFiManager::printBSSID(Print &out, const uint8_t *bssid)
+{
+    out.printf("%02X:%02X:%02X:%02X:%02X:%02X", bssid[0], bssid[1], bssid[2], bssid[3], bssid[4], bssid[5]);
+}
+
+void WiFiManager::printMAC(Print &out)
+{
+    uint8_t mac[6];
+    WiFi.macAddress(mac);
+    out.printf("%02X:%02X:%02X:%02X:%02X:%02X", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
 }
\ No newline at end of file
@@ -22,9 +22,16 @@
 #error "Cette librairie nécessite ESP8266 ou ESP32"
 #endif
 
+// Serveur multi-connexions non bloquant à la place du serveur du core (même API)
+#ifdef WIFI_MANAGER_MULTI_CLIENT
+#include "MultiClientWebServer.h"
+#undef WebServerType
+#define WebServerType MultiClientWebServer
+#endif
+
 #include <WiFiUdp.h>
+#include <Preferences.h>
 #include <time.h>
-#include "HomePage.h" // default Home Page
 
 // États de connexion
 enum WifiState
@@ -36,6 +43,60 @@ enum WifiState
     WIFI_CONNECTION_LOST
 };
 
+// Réseau trouvé par un scan (copie : la mémoire du SDK est libérée après le scan)
+struct ScanResult
+{
+    char ssid[33];
+    uint8_t bssid[6];
+    int8_t rssi;
+    uint8_t channel;
+    bool encrypted;
+};
+
+// Dernière connexion réussie, mémorisée en flash pour la reconnexion rapide
+// Pas de bail DHCP : l'IP est toujours redemandée au routeur (voir README)
+struct FastConnectCache
+{
+    char ssid[33]; // Réseau connu auquel appartient ce BSSID
+    uint8_t bssid[6];
+    uint8_t channel;
+};
+
+// Événement de liaison (historique circulaire)
+enum LinkEventType
+{
+    LINK_DOWN,     // Perte de connexion (raison SDK, 0 : roaming volontaire)
+    LINK_UP,       // Connexion rétablie (durée de la coupure)
+    LINK_AP_CHANGE // Nouveau BSSID ou nouveau canal par rapport à la connexion précédente
+};
+
+struct LinkEvent
+{
+    unsigned long time;  // millis() de l'événement
+    uint32_t durationMs; // LINK_UP : durée de la coupure
+    uint8_t bssid[6];
+    uint8_t type; // LinkEventType
+    uint8_t reason;
+    uint8_t channel;
+    int8_t rssi;
+};
+
+// Réseau connu (identifiants copiés)
+struct WiFiNetwork
+{
+    char ssid[33];
+    char password[65];
+};
+
+// Statistiques par route HTTP (nombre de requêtes et durée des handlers)
+struct RouteStats
+{
+    const char *uri; // Non copiée : doit rester valide (littéral)
+    uint32_t count;
+    uint64_t totalUs;
+    uint32_t maxUs;
+};
+
 // Type de callback pour les événements
 typedef void (*WiFiEventCallback)(WifiState state);
 typedef void (*WebHandler)(WebServerType &server);
@@ -44,23 +105,102 @@ class WiFiManager
 {
 private:
     // Configuration WiFi
-    const char *ssid;
-    const char *password;
     const char *hostname;
 
+    // Réseaux connus : [0] celui du constructeur, les suivants persistés en flash
+    static const uint8_t MAX_NETWORKS = 4;
+    static const unsigned long RANKING_MAX_AGE_MS = 10 * 60 * 1000UL; // Scan plus ancien : ignoré pour le classement
+    WiFiNetwork networks[MAX_NETWORKS];
+    uint8_t networkCount;
+    uint8_t candidates[MAX_NETWORKS]; // Ordre d'essai du cycle en cours (RSSI décroissant)
+    uint8_t candidateCount;
+    uint8_t candidateIndex;
+    uint8_t currentNetwork; // Réseau de la tentative en cours ou de la connexion
+
+    // Roaming : scan périodique, changement d'AP si un AP connu est nettement plus fort
+    unsigned long roamInterval; // 0 : désactivé
+    int8_t roamThreshold;       // Gain minimum (dB)
+    unsigned long lastRoamCheck;
+    bool roamScanPending;
+    bool attemptRoam;
+    uint32_t roamCount;
+
+    // Qualité de liaison : échantillons RSSI et événements (tampons circulaires)
+    static const uint8_t RSSI_HISTORY = 60; // 10 min à 10 s
+    static const uint8_t MAX_LINK_EVENTS = 16;
+    int8_t rssiSamples[RSSI_HISTORY];
+    uint8_t rssiHead;
+    uint8_t rssiCount;
+    unsigned long rssiSampleInterval;
+    unsigned long lastRssiSample;
+    LinkEvent linkEvents[MAX_LINK_EVENTS];
+    uint8_t linkEventHead;
+    uint8_t linkEventCount;
+    bool outageOpen;
+    unsigned long outageStart;
+    uint32_t outageCount;
+    uint32_t outageTotalMs;
+    uint32_t longestOutageMs;
+    uint8_t lastBSSID[6]; // AP de la connexion précédente
+    uint8_t lastChannel;
+
     // Serveur Web
     WebServerType *webServer;
     bool serverEnabled;
     uint16_t serverPort;
 
+    // Statistiques des routes
+    static const uint8_t MAX_ROUTE_STATS = 24;
+    RouteStats routeStats[MAX_ROUTE_STATS];
+    uint8_t routeStatsCount;
+
+    // Scan des réseaux (asynchrone, résultats en cache)
+    static const uint8_t MAX_SCAN_RESULTS = 16; // Les plus forts sont conservés
+    ScanResult scanResults[MAX_SCAN_RESULTS];
+    uint8_t scanResultCount;
+    bool scanRunning;
+    bool scanValid;
+    unsigned long scanStartTime;
+    unsigned long scanTime; // Fin du dernier scan
+    unsigned long scanTtlMs;
+
     // État
     WifiState currentState;
     unsigned long startConnectTime; // Pour le timeout non bloquant
     bool isConnecting = false;      // Flag pour savoir si on attend une réponse
     unsigned long lastConnectionAttempt;
     unsigned long connectionTimeout;
-    uint8_t reconnectAttempts;
-    uint8_t maxReconnectAttempts;
+    uint8_t reconnectAttempts;    // Cycles échoués, saturé à 255
+    uint8_t maxReconnectAttempts; // 0 : illimité
+    unsigned long reconnectBaseDelay;
+    unsigned long reconnectMaxDelay;
+    unsigned long nextAttemptTime;
+    bool retryScheduled;
+
+    // Reconnexion rapide : BSSID et canal de la dernière connexion (sans scan)
+    static const unsigned long FAST_CONNECT_TIMEOUT_MS = 5000; // Au-delà : scan complet
+    bool fastConnectEnabled;
+    bool fastCacheValid;
+    bool fastPathFailed; // Jusqu'à la prochaine connexion réussie
+    bool attemptFast;    // Chemin de la tentative en cours
+    FastConnectCache fastCache;
+    bool useStaticIP;
+    IPAddress staticIP, staticGateway, staticSubnet, staticDNS;
+
+    // Temps de connexion par chemin (ms, dernière connexion réussie)
+    unsigned long lastConnectMs;
+    bool lastConnectFast;
+    unsigned long fastConnectMs;
+    unsigned long fullConnectMs;
+
+    // Événements WiFi (posés par les callbacks du SDK, traités par checkConnection())
+    volatile bool eventGotIP;
+    volatile bool eventDisconnected;
+    volatile uint8_t disconnectReason;
+#ifdef ESP8266
+    WiFiEventHandler gotIPHandler; // Les handlers doivent rester en vie
+    WiFiEventHandler disconnectedHandler;
+#endif
 
     // Callbacks
     WiFiEventCallback onStateChange;
@@ -73,7 +213,35 @@ private:
 
     // Méthodes privées
     void updateState(WifiState newState);
+    void registerEvents();
+    void startAttempt(bool newCycle = true);
+    void failAttempt();
+    void applyIPConfig();
+    void rankCandidates();
+    int8_t findNetwork(const char *ssid) const;
+    const ScanResult *findBestScan(uint8_t network) const;
+    void checkRoaming();
+    void sampleLink();
+    void beginOutage(uint8_t reason);
+    void recordLinkEvent(LinkEventType type, uint8_t reason, uint32_t durationMs);
+    void writeLinkJSON(Print &out);
+    void roamTo(uint8_t network, const ScanResult &ap);
+    void loadNetworks();
+    void saveNetworks();
+    void scheduleRetry();
+    void onConnected();
+    void loadFastCache();
+    void saveFastCache();
     void printConnectionStatus();
+    size_t formatTime(char *buffer, size_t size, const char *format);
+    const char *getStateLabel();
+    const char *getSignalLabel(int rssi);
+    void printMAC(Print &out);
+    static void printBSSID(Print &out, const uint8_t *bssid);
+    RouteStats *addRouteStats(const char *uri);
+    static void recordRoute(RouteStats *stats, unsigned long startUs);
+    void pollScan();
+    void storeScanResults(int count);
 
 public:
     // Constructeur
@@ -82,14 +250,43 @@ public:
     // Initialisation
     bool begin();
     void setConnectionTimeout(unsigned long timeoutMs);
-    void setMaxReconnectAttempts(uint8_t attempts);
+    void setMaxReconnectAttempts(uint8_t attempts);                // 0 : illimité (par défaut)
+    void setReconnectBackoff(unsigned long baseMs, unsigned long maxMs); // 1 s à 5 min par défaut
 
     // Connexion WiFi
-    bool connect();
+    bool connect();         // Bloquant (démarrage uniquement)
+    void connectAsync();    // Non bloquant : la connexion se poursuit dans checkConnection()
     bool isConnected();
     void disconnect();
-    void reconnect();
-    void checkConnection(); // À appeler dans loop()
+    void reconnect();       // Tentative immédiate, non bloquante
+    void checkConnection(); // À appeler dans loop() : machine à états non bloquante
+    uint8_t getReconnectAttempts() const;
+
+    // Réseaux connus (essayés du plus fort au plus faible selon le dernier scan)
+    bool addNetwork(const char *ssid, const char *password); // Persisté ; false si la liste est pleine
+    bool removeNetwork(const char *ssid);                    // Sauf le réseau du constructeur
+    uint8_t getNetworkCount() const;
+    const char *getNetworkSSID(uint8_t index) const;
+
+    // Roaming (désactivé par défaut)
+    void setRoaming(unsigned long intervalMs, int8_t thresholdDb = 12);
+    uint32_t getRoamCount() const;
+
+    // Qualité de liaison (échantillon RSSI toutes les 10 s par défaut, 60 conservés)
+    void setLinkSampleInterval(unsigned long ms);
+    uint8_t getRSSIStats(int8_t &min, int8_t &median, int8_t &max) const; // Nombre d'échantillons
+    uint32_t getOutageCount() const;
+    uint32_t getOutageTotalMs() const; // Coupure en cours comprise
+    uint8_t getLinkEventCount() const;
+    const LinkEvent &getLinkEvent(uint8_t index) const; // 0 : le plus récent ; time = 0 si aucun événement
+
+    // Reconnexion rapide et IP fixe
+    void enableFastConnect(bool enable = true); // Activée par défaut
+    void clearFastConnectCache();
+    void setStaticIP(IPAddress ip, IPAddress gateway, IPAddress subnet, IPAddress dns = IPAddress((uint32_t)0));
+    unsigned long getLastConnectTime() const; // ms de WiFi.begin() à l'obtention de l'IP
+    bool isLastConnectFast() const;
+    uint8_t getLastDisconnectReason() const;
 
     // Informations WiFi
     String getIP();
@@ -107,7 +304,7 @@ public:
     // Serveur Web
     bool startWebServer(uint16_t port = 80);
     void stopWebServer();
-    void handleClient(); // À appeler dans loop()
+    void handleClient(); // À appeler dans loop() (suit aussi le scan en cours)
     WebServerType *getServer();
 
     // Routes HTTP
@@ -116,11 +313,17 @@ public:
     void onNotFound(WebHandler handler);
     void serveStatic(const char *uri, const char *contentType, const char *content);
 
+    // Statistiques des routes (une entrée par URI, toutes méthodes confondues)
+    uint8_t getRouteStatsCount() const;
+    const RouteStats &getRouteStats(uint8_t index) const;
+
     // Pages par défaut
     void enableDefaultPages(bool enable = true);
     String getDefaultHTML();
     String getStatusJSON();
     String getStatusHTML();
+    void writeStatusJSON(Print &out); // Écriture en flux, sans String
+    void writeStatusHTML(Print &out);
 
     // NTP (récupération de l'heure)
     void enableNTP(const char *server = "pool.ntp.org", long gmtOffset = 0, int dstOffset = 0);
@@ -143,9 +346,17 @@ public:
     void enableAutoReconnect(bool enable = true);
 
     // Scan des réseaux
-    int scanNetworks();
+    int scanNetworks();                // Bloquant (~2 s) : préférer startScan()
+    bool startScan();                  // Non bloquant : false si un scan est déjà en cours
+    bool isScanning() const;
+    bool isScanFresh() const;          // Résultats plus récents que le TTL
+    unsigned long getScanAge() const;  // ms depuis la fin du dernier scan
+    void setScanTTL(unsigned long ttlMs);
+    uint8_t getScanResultCount() const;
+    const ScanResult &getScanResult(uint8_t index) const;
     String getScannedNetwork(int index);
     String getScannedNetworkJSON();
+    void writeScannedNetworkJSON(Print &out);
 };
 
 #endif // WIFI_MANAGER_H
\ No newline at end of file
@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+"""Générateur de charge pour comparer les deux serveurs web de WiFiManager.
+
+Envoie des GET en parallèle pendant une durée fixe, avec ou sans keep-alive,
+et affiche le débit (requêtes/s) et les latences p50 / p99 / max.
+
+    python3 charge_web.py 192.168.1.91 /api/data --clients 4 --duree 30
+    python3 charge_web.py 192.168.1.91 /api/data --clients 4 --duree 30 --sans-keep-alive
+
+À lancer sur un build ESP8266WebServer puis sur un build -D WIFI_MANAGER_MULTI_CLIENT,
+même route, même nombre de clients, ESP au même endroit du réseau.
+Bibliothèque standard Python 3 uniquement.
+"""
+
+import argparse
+import http.client
+import threading
+import time
+
+
+def client(hote, port, chemin, keep_alive, fin, latences, erreurs, verrou):
+    connexion = None
+    mesures = []
+    echecs = 0
+    while time.monotonic() < fin:
+        debut = time.monotonic()
+        try:
+            if connexion is None:
+                connexion = http.client.HTTPConnection(hote, port, timeout=5)
+            connexion.request("GET", chemin, headers={} if keep_alive else {"Connection": "close"})
+            reponse = connexion.getresponse()
+            reponse.read()
+            if reponse.status != 200:
+                echecs += 1
+            else:
+                mesures.append(time.monotonic() - debut)
+            if not keep_alive or reponse.will_close:
+                connexion.close()
+                connexion = None
+        except (OSError, http.client.HTTPException):
+            echecs += 1
+            if connexion is not None:
+                connexion.close()
+                connexion = None
+            time.sleep(0.05)
+    if connexion is not None:
+        connexion.close()
+    with verrou:
+        latences.extend(mesures)
+        erreurs.append(echecs)
+
+
+def centile(valeurs, q):
+    if not valeurs:
+        return 0.0
+    return valeurs[min(len(valeurs) - 1, int(q * len(valeurs)))]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("hote")
+    parser.add_argument("chemin", nargs="?", default="/api/data")
+    parser.add_argument("--port", type=int, default=80)
+    parser.add_argument("--clients", type=int, default=4)
+    parser.add_argument("--duree", type=float, default=30.0, help="secondes")
+    parser.add_argument("--sans-keep-alive", action="store_true")
+    args = parser.parse_args()
+
+    keep_alive = not args.sans_keep_alive
+    latences = []
+    erreurs = []
+    verrou = threading.Lock()
+    fin = time.monotonic() + args.duree
+    threads = [
+        threading.Thread(target=client,
+                         args=(args.hote, args.port, args.chemin, keep_alive, fin, latences, erreurs, verrou))
+        for _ in range(args.clients)
+    ]
+    debut = time.monotonic()
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    duree = time.monotonic() - debut
+
+    latences.sort()
+    print(f"{args.chemin}, {args.clients} clients, keep-alive {'oui' if keep_alive else 'non'}, {duree:.1f} s")
+    print(f"  {len(latences)} réponses 200, {sum(erreurs)} erreurs")
+    print(f"  {len(latences) / duree:.1f} requêtes/s")
+    print(f"  latence p50 {centile(latences, 0.50) * 1000:.1f} ms, "
+          f"p99 {centile(latences, 0.99) * 1000:.1f} ms, "
+          f"max {(latences[-1] if latences else 0) * 1000:.1f} ms")
+
+
+if __name__ == "__main__":
+    main()
@@ -6,33 +6,55 @@
 WiFiManager wifi(WIFI_SSID, WIFI_PASSWORD, AP_HOSTNAME);
 OTAManager ota(OTA_HOSTNAME, OTA_PASSWORD, OTA_PORT);
 RTCManager myRTC(DS1302_CLK_PIN, DS1302_DAT_PIN, DS1302_RST_PIN); // RTC module 2
-Servo monServomoteur;                                             // Servomoteur
-Preferences preferences;                                          // Persistent memory
+ServoDriver monServomoteur(SERVO_PIN);                           // Servomoteur, détaché au repos
+PreferencesComptees preferences;                                  // Persistent memory (écritures comptées pour /metrics)
 OLEDDisplay oled(SCREEN_WIDTH, SCREEN_HEIGHT, OLED_I2C_ADRESS);
+ScreenManager ecrans(oled); // Écrans et file de messages, rotation depuis oled.update()
 InputBouton boutonTactile(BOUTON_PIN, LOW, INPUT);
+EventStream evenements(MAX_FLUX_SSE); // Push SSE vers les dashboards
+CommandQueue commandes(COMMANDES_REGROUPEMENT_MS); // Demandes web, bouton et auto, exécutées dans loop()
+BootTimeline chronoDemarrage(__DATE__ " " __TIME__); // Étapes du démarrage en µs (/api/boot)
 
 // -------------------           DECLARATION DES FONCTIONS (début)           ------------------- /                                                           // (setup) Connecte la mémoire persistante
-void setupWiFi();                                    // (setup) Connecte le wifi
+void setupWiFi();                                    // (setup) Lance la connexion wifi, sans attendre
+void gererDemarrage();                               // (loop) Services réseau et NTP dès que la liaison est établie
+bool demarrerServicesReseau();                       // Serveur web et OTA
+void marquerPhase(PhaseDemarrage phase);             // Enregistre la fin d'une phase du démarrage
+void suivreChronoDemarrage();                        // (loop) Première requête web, puis enregistrement de la chronologie
 void setupWebRoutes();                               // (setup) Initialise les pages web
 void getSavedSettings();                             // (setup) Récupère la data de la mémoire persistante
 void setupRtc();                                     // (setup) Initialise le module d'horloge
 boolean syncRTCFromWiFi();                           // Synchronise la date RTC avec la date WiFi
 void setupBoutons();                                 // (setup) Initialise les paramètres boutons
 void setupScreen();                                  // (setup) Connecte l'écran OLED
-void displayHomeScreen(unsigned int displayTimeSec); // Affiche l'écran de bord
-void displayInfoScreen(unsigned int displayTimeSec); // Affiche les compteurs
+void displayHomeScreen();                            // Dessine l'écran de bord (SCREEN_HOME)
+void displayInfoScreen();                            // Dessine les compteurs (SCREEN_INFO)
+DonneesEcrans lireDonneesEcrans();                   // Heure et compteurs pour les deux écrans ci-dessus
 
 // Fonctions Pour nourrir le chat
 void setAutoMiam(bool isActivated);
 void setMiamTime(unsigned int h, unsigned int m, String type);
+const char *appliquerReglages(JsonObjectConst reglages); // Réglages groupés : nullptr si appliqués, sinon le champ refusé
 boolean verifierRegime();
 boolean detecterCroquettes();          // Détecte la présence de croquette, retourne (0) abscence || (1) présence
 void openValve(unsigned int timeOpen); // Contrôle le servomoteur
 int calculerMasseEngloutie();
 void addHistoryPoint(unsigned long t, int m); // historique des distributions
 void reinitialiserCompteurs();                // Réinitialise les compteurs
-void feedCat(boolean grossePortion);          // Distribue les (0) Croquinettes || (1) Croquettes
+ResultatDistribution feedCat(boolean grossePortion, SourceCommande source); // Distribue les (0) Croquinettes || (1) Croquettes
 void calibrerDistributeur(int repetitions, int startTimeOpen, int endTimeOpen, int step);
+int16_t executerCommande(const Command &commande); // Exécutant unique de la file de commandes
+void terminerCommande(const Command &commande);    // Fin d'une commande : compteurs et événement SSE
+
+// Fonctions Web
+void incrementerVersionEtat();                               // À appeler après chaque modification de l'état
+void publierEtat();                                          // Pousse les changements d'état aux clients SSE
+void ecrireCle(Print &out, boolean &premier, const char *cle); // Écrit ,"cle": dans un objet JSON
+void ecrireDonneesJSON(Print &out);                          // État complet (/api/data), sans allocation
+int echantillonnerHistorique(int debut, int fin, int maxPoints, uint8_t *indices); // LTTB
+void ecrireCommandeJSON(Print &out, const Command &commande); // {"id":..,"state":..,"source":..,"result":..}
+void ecrireMetriques(Print &out);                            // Exposition Prometheus (/metrics), sans allocation
+uint64_t millis64();                                         // millis() sans débordement à 49 jours
 // -------------------           DECLARATION DES FONCTIONS (fin)           ------------------- /
 
 // -------------------                INITIALISATION (début)                ------------------- /
@@ -40,16 +62,32 @@ void setup()
 {
   DEBUG_INIT(SERIAL_BAUD_RATE);                                // Initialisation de la communication filaire                                              // wait until Arduino Serial Monitor opens
   DEBUG_PRINTLN(F("START Croquinator from " __DATE__ "\r\n")); //  Just to know which program is running
-
-  setupScreen();                         // Initialisation de l'écran OLED
-  getSavedSettings();                    // Récupération de la mémoire persistante
-  setupWiFi();                           // Configuration du WiFi
-  setupRtc();                            // Syncrhonisation de l'horloge interne
-  monServomoteur.attach(SERVO_PIN);      // Configuration du Servomoteur
-  monServomoteur.write(ANGLE_FERMETURE); // S'assure que la valve est fermée au démarrage
-  setupBoutons();                        // Configuration des boutons
-
+  chronoDemarrage.begin();                                      // Raison du reset, démarrage précédent
+  identifiantDemarrage = ESP.random();                          // Identifiant de boot pour les ETag
+
+  // Le WiFi s'associe en tâche de fond pendant le reste du démarrage : la distribution est
+  // opérationnelle sans réseau, web, OTA et NTP sont attachés par gererDemarrage() dans loop()
+  chronoDemarrage.measure("setupScreen", setupScreen);           // Initialisation de l'écran OLED
+  marquerPhase(PHASE_ECRAN);
+  chronoDemarrage.measure("setupWiFi", setupWiFi);               // Connexion WiFi non bloquante
+  chronoDemarrage.measure("getSavedSettings", getSavedSettings); // Récupération de la mémoire persistante
+  marquerPhase(PHASE_MEMOIRE);
+  chronoDemarrage.measure("setupRtc", setupRtc);                 // Lecture de l'horloge interne (synchronisée plus tard)
+  marquerPhase(PHASE_HORLOGE);
+  chronoDemarrage.measure("servo.attach", []()
+                          {
+                            monServomoteur.setSettleTime(SERVO_STABILISATION_MS);
+                            monServomoteur.begin(ANGLE_FERMETURE); // S'assure que la valve est fermée au démarrage
+                          });
+  chronoDemarrage.measure("setupBoutons", setupBoutons);         // Configuration des boutons
+  commandes.onExecute(executerCommande); // Servo, écran et mémoire hors des handlers web
+  commandes.onComplete(terminerCommande);
+  marquerPhase(PHASE_DISTRIBUTION);
+
+#ifdef CALIBRATION_AU_DEMARRAGE
   calibrerDistributeur(1, 100, 1000, 100);
+#endif
+  oled.setAsyncFlush(true); // Désormais l'écran est envoyé par morceaux depuis oled.update()
 }
 // -------------------                INITIALISATION (fin)                ------------------- /
 
@@ -57,16 +95,33 @@ void setup()
 void loop()
 {
   // DEBUG_PRINTLN("Début de la Boucle principale");
+  // Latence de la boucle : intervalle entre deux passages (inclut les handlers web et l'affichage)
+  static unsigned long debutBoucle = 0;
+  const unsigned long maintenantUs = micros();
+  if (debutBoucle != 0)
+  {
+    latenceBoucle.record(maintenantUs - debutBoucle);
+  }
+  debutBoucle = maintenantUs;
+  millis64(); // Détection du débordement de millis()
+
   // Appeler à chaque début de boucle
   wifi.checkConnection();
+  gererDemarrage(); // Rien à faire une fois l'heure réseau obtenue
   wifi.handleClient();
+  suivreChronoDemarrage(); // Rien à faire une fois la chronologie enregistrée
   ota.handle();
-  myRTC.update(); // Always update time
+  commandes.process(); // Au plus une distribution par boucle
+  evenements.handle(); // Keep-alive des flux SSE
+  publierEtat();       // Push des changements vers les dashboards
+  myRTC.update();      // Always update time
+  monServomoteur.update(); // Détache le servo une fois la valve fermée
   oled.update();  // Loop Ecran OLED
 
   // --------- AutoCatFeed (début) --------- //
   // Vérifier la plage horaire toutes les secondes
   static unsigned long lastCheck = 0;
+  static uint32_t commandeAuto = 0; // Dernière distribution automatique déposée
   if (autoMiamActivated && millis() - lastCheck > 1000)
   {
     lastCheck = millis();
@@ -78,13 +133,22 @@ void loop()
       // Serial.print("✓ Dans plage nourrissage");
       // Verifier le délai depuis le dernier croq
       long deltaSecondes = myRTC.getSecondsFromMidnight() - lastFeedTimeCroquettes; // interval de temps
-      const unsigned long delay = delayDistributionCroquettesSec + compteurAbsenceChat * SNOOZE_DELAY_SEC;
+      const unsigned long delay = delayDistributionCroquettesSec + compteurAbsenceChat * snoozeDelaySec;
       // char message[56];
       // sprintf(message, "Maintenant: %d s - lastFeed: %d s - delta: %d s - delay: %d s", maintenantSec, lastFeedTimeCroquettes, deltaSecondes, delay);
       // DEBUG_PRINTLN(message);
       if (deltaSecondes > 0 && (unsigned int)deltaSecondes >= delay) // Si le délai de 2H est écoulé
       {
-        feedCat(1); // Donner des croquettes
+        // Une seule demande automatique à la fois : pas de nouveau dépôt tant que la précédente
+        // attend, ni dans le délai de regroupement qui suit (elle serait refusée comme doublon)
+        const Command *precedente = commandes.find(commandeAuto);
+        const boolean enCours = precedente != nullptr &&
+                                (precedente->state == COMMAND_PENDING || precedente->state == COMMAND_RUNNING ||
+                                 millis() - precedente->finishedAt < COMMANDES_REGROUPEMENT_MS);
+        if (!enCours)
+        {
+          commandeAuto = commandes.enqueue(COMMANDE_DISTRIBUTION, 1, SOURCE_AUTO); // Donner des croquettes
+        }
       }
     }
   }
@@ -106,13 +170,13 @@ void loop()
 
   case BUTTON_SHORT_CLICK:
     DEBUG_PRINTLN("--- APPUIS COURT (SIMPLE CLIC) DETECTE ---");
-    displayHomeScreen(DISPLAY_TIME_SEC); // Afficher les dernières croquettes et croquinettes servies
+    ecrans.showScreen(SCREEN_HOME, DISPLAY_TIME_SEC); // Afficher les dernières croquettes et croquinettes servies
     break;
 
   case BUTTON_LONG_PRESS:
   {
     DEBUG_PRINTLN("--- APPUI LONG DETECTE ---");
-    displayInfoScreen(DISPLAY_TIME_SEC); // Affiche les compteurs
+    ecrans.showScreen(SCREEN_INFO, DISPLAY_TIME_SEC); // Affiche les compteurs
     break;
   }
 
@@ -134,11 +198,11 @@ void loop()
     DEBUG_PRINTLN(" clics");
     if (clics == 2)
     {
-      feedCat(0); // Donner des croquinettes
+      commandes.enqueue(COMMANDE_DISTRIBUTION, 0, SOURCE_BOUTON); // Donner des croquinettes
     }
     else if (clics == 3)
     {
-      feedCat(1); //  Distribution dose normal de croquettes
+      commandes.enqueue(COMMANDE_DISTRIBUTION, 1, SOURCE_BOUTON); //  Distribution dose normal de croquettes
     }
     break;
   }
@@ -160,18 +224,19 @@ void setAutoMiam(bool isActivated)
   {
     autoMiamActivated = false;
     DEBUG_PRINTLN("[FitCat] Auto-miam désactivé");
-    oled.printMessage("FitCat", "Desactivation de l'Auto-miam.", DISPLAY_TIME_SEC);
+    ecrans.showMessage("FitCat", "Désactivation de l'Auto-miam.", DISPLAY_TIME_SEC);
   }
   else
   {
     autoMiamActivated = true;
     DEBUG_PRINTLN("[FitCat] Auto-miam activé");
-    oled.printMessage("FitCat", "Activation de l'Auto-miam.", DISPLAY_TIME_SEC);
+    ecrans.showMessage("FitCat", "Activation de l'Auto-miam.", DISPLAY_TIME_SEC);
   }
   // Sauvegarder dans la mémoire persistante
   preferences.begin("croquinator", false);
   preferences.putBool("autoMiam", autoMiamActivated);
   preferences.end(); // Ferme l'accès à la mémoire. C'est CRUCIAL.
+  incrementerVersionEtat();
 }
 void setMiamTime(unsigned int h, unsigned int m, String type)
 {
@@ -194,14 +259,15 @@ void setMiamTime(unsigned int h, unsigned int m, String type)
     DEBUG_PRINTF("[FitCat] Nouvelle fin : %02dh%02d\n", h, m);
   }
   preferences.end(); // Ferme l'accès à la mémoire. C'est CRUCIAL.
-  oled.printMessage("FitCat", "Plage horaire mise à jour.", DISPLAY_TIME_SEC);
+  incrementerVersionEtat();
+  ecrans.showMessage("FitCat", "Plage horaire mise à jour.", DISPLAY_TIME_SEC);
 }
 boolean verifierRegime()
 {
   DEBUG_PRINT("Verification du régime du chat... ");
   masseEngloutieParLeChatEnG = calculerMasseEngloutie();
   DEBUG_PRINT(masseEngloutieParLeChatEnG);
-  if (masseEngloutieParLeChatEnG < RATION_QUOTIDIENNE_G)
+  if (masseEngloutieParLeChatEnG < rationQuotidienneG)
   {
     DEBUG_PRINTLN("g engloutis. El Gazou respecte son régime.");
     return true;
@@ -231,28 +297,33 @@ void calibrerDistributeur(int repetitions, int startTimeOpen, int endTimeOpen, i
 {
   DEBUG_PRINTLN("[FitCat] Calibration du distributeur");
   autoMiamActivated = false;
+  incrementerVersionEtat();
 
   for (int t = startTimeOpen; t <= endTimeOpen; t += step)
   {
     DEBUG_PRINTF("[Calibration] Temps d'ouverture %d ms %d répétitions - début dans 10sec..", t, repetitions);
     char message[60];
     sprintf(message, "Temps d'ouverture %d ms %d repetitions - debut dans 10sec..", t, repetitions);
-    oled.printMessage("Calibrer", message, 10);
+    oled.drawMessage("Calibrer", message); // Affichage direct : séquence bloquante
+    oled.refresh();
     delay(10 * 1000); // délais entre chaque temps d'ouverture
     for (int i = 1; i <= repetitions; i++)
     {
       DEBUG_PRINTF(" %d..", i);
-      oled.printMessage("Calibrer", String(i), 1);
+      oled.drawMessage("Calibrer", String(i).c_str());
+      oled.refresh();
       openValve(t);
       delay(500); // délais entre chaque repetition
     }
     DEBUG_PRINTLN(" OK, mesurer masse totale !");
-    oled.printMessage("Calibrer", "OK, mesurer masse totale !", 10);
+    oled.drawMessage("Calibrer", "OK, mesurer masse totale !");
+    oled.refresh();
     delay(10 * 1000);
   }
 
   DEBUG_PRINTLN("[FitCat] Calibration terminée");
-  oled.printMessage("Calibrer", "Calibration terminee", 10);
+  ecrans.refresh(); // L'écran a été dessiné hors du gestionnaire
+  ecrans.showMessage("Calibrer", "Calibration terminée", 10);
 }
 void openValve(unsigned int timeOpen)
 {
@@ -260,13 +331,30 @@ void openValve(unsigned int timeOpen)
   DEBUG_PRINT(timeOpen);
   DEBUG_PRINTLN(" ms).");
 
-  monServomoteur.write(ANGLE_OUVERTURE); // Ouvre
-  delay(timeOpen);                       // Attend 0,5 seconde pour laisser tomber la portion
-  monServomoteur.write(ANGLE_FERMETURE); // Ferme
+  // La fermeture commence timeOpen ms après le début de l'ouverture, comme avec write() ; une
+  // portion plus courte que la rampe (CROQUINETTES) raccourcit la rampe. La valve s'ouvre
+  // toutefois moins vite qu'avec write() : la quantité distribuée change, surtout pour les
+  // petites portions, à recalibrer (calibrerDistributeur). Le servo est détaché plus tard par update()
+  const uint16_t rampe = timeOpen < SERVO_RAMPE_OUVERTURE_MS ? timeOpen : SERVO_RAMPE_OUVERTURE_MS;
+  boolean sequence = monServomoteur.moveTo(ANGLE_OUVERTURE, rampe) && // Ouvre
+                     monServomoteur.hold(timeOpen - rampe);
+  if (sequence && SECOUSSE_CYCLES > 0)
+  {
+    sequence = monServomoteur.shake(SECOUSSE_AMPLITUDE, SECOUSSE_CYCLES, SECOUSSE_PERIODE_MS);
+  }
+  sequence = sequence && monServomoteur.moveTo(ANGLE_FERMETURE, SERVO_RAMPE_FERMETURE_MS); // Ferme
+  if (!sequence)
+  {
+    // Séquence pleine : ne jamais laisser la valve ouverte, fermeture immédiate
+    DEBUG_PRINTLN("[Servo] ✗ Séquence incomplète, fermeture de la valve");
+    monServomoteur.stop();
+    monServomoteur.moveTo(ANGLE_FERMETURE, SERVO_RAMPE_FERMETURE_MS);
+  }
+  monServomoteur.waitMove(); // Bloquant jusqu'à la fermeture
 }
 int calculerMasseEngloutie()
 {
-  return compteurDeCroquettes * RATION_CROQUETTES_G + compteurDeCroquinettes * RATION_CROQUINETTES_G;
+  return compteurDeCroquettes * rationCroquettesG + compteurDeCroquinettes * rationCroquinettesG;
 };
 void addHistoryPoint(unsigned long time, int mass)
 {
@@ -274,6 +362,7 @@ void addHistoryPoint(unsigned long time, int mass)
   {
     feedingHistory[historySize] = {time, mass};
     historySize++;
+    incrementerVersionEtat();
   }
 }
 void optimiserDelayDistributionCroquettes()
@@ -281,7 +370,7 @@ void optimiserDelayDistributionCroquettes()
   DEBUG_PRINT("Optimisation de la prochaine distribution.. ");
   masseEngloutieParLeChatEnG = calculerMasseEngloutie();
   const long finDeLaPlageDansSec = ((heureFinMiam * 60 + minuteFinMiam) * 60) - myRTC.getSecondsFromMidnight();
-  const int nombreDistributionCroquettesRestant = (RATION_QUOTIDIENNE_G - masseEngloutieParLeChatEnG) / RATION_CROQUETTES_G;
+  const int nombreDistributionCroquettesRestant = (rationQuotidienneG - masseEngloutieParLeChatEnG) / rationCroquettesG;
 
   DEBUG_PRINT("Nombre de distributions restantes: ");
   DEBUG_PRINTLN(nombreDistributionCroquettesRestant);
@@ -309,30 +398,35 @@ void reinitialiserCompteurs()
   compteurDeCroquettes = 0;
   compteurDeCroquinettes = 0;
   compteurAbsenceChat = 0;
-  lastFeedTimeCroquettes = ((heureDebutMiam * 60 + minuteDebutMiam) * 60) - FEED_DELAY_CROQUETTES_SEC;
+  lastFeedTimeCroquettes = ((heureDebutMiam * 60 + minuteDebutMiam) * 60) - feedDelayCroquettesSec;
   lastFeedTimeCroquinettes = 0;
-  delayDistributionCroquettesSec = FEED_DELAY_CROQUETTES_SEC;
+  delayDistributionCroquettesSec = feedDelayCroquettesSec;
+  historySeqDebut += historySize;                     // Les séquences restent croissantes
   historySize = 0;                                    // Réinitialisation de l'historique
   addHistoryPoint(myRTC.getSecondsFromMidnight(), 0); // Point de départ à 0g
 
-  preferences.begin("croquinator", true);
-  lastFeedTimeCroquettes = preferences.putULong("croquetteTime", lastFeedTimeCroquettes);
-  lastFeedTimeCroquinettes = preferences.putULong("croquinetteTime", lastFeedTimeCroquinettes);
-  compteurDeCroquettes = preferences.putUInt("compteurCroquette", compteurDeCroquettes);
-  compteurDeCroquinettes = preferences.putUInt("compteurCroquinette", compteurDeCroquinettes);
+  preferences.begin("croquinator", false);
+  preferences.putULong("croquetteTime", lastFeedTimeCroquettes);
+  preferences.putULong("croquinetteTime", lastFeedTimeCroquinettes);
+  preferences.putUInt("compteurCroquette", compteurDeCroquettes);
+  preferences.putUInt("compteurCroquinette", compteurDeCroquinettes);
   preferences.end(); // Ferme l'accès à la mémoire. C'est CRUCIAL.
+  incrementerVersionEtat();
 
   DEBUG_PRINTLN("Compteurs reinitialises.");
-  oled.printMessage("Compteurs", "Reinitialisation des compteurs.", DISPLAY_TIME_SEC);
+  ecrans.showMessage("Compteurs", "Réinitialisation des compteurs.", DISPLAY_TIME_SEC);
 }
 /* Fonction pour nourrir le chat
 Vérifie la présence de croquettes et les distribue
 @args
 grossePortion : true (croquettes) | false (croquinettes)
+source : origine de la demande (web, bouton, auto), comptée pour /metrics
+@return l'issue de la demande
 */
-void feedCat(boolean grossePortion)
+ResultatDistribution feedCat(boolean grossePortion, SourceCommande source)
 {
   DEBUG_PRINTLN("Nourrir le chat !");
+  ResultatDistribution resultat;
   const boolean presenceDeCroquettes = detecterCroquettes(); // Vérifier si il y a des croquettes
   const boolean leRegimeEstRespecte = verifierRegime();      // Vérifier la quantité engloutée
 
@@ -343,12 +437,15 @@ void feedCat(boolean grossePortion)
     { // Croquettes
       DEBUG_PRINTLN("Distribution des croquettes reportee");
       compteurAbsenceChat++;
-      oled.printMessage("No gazou", "Gazou est absent, distribution des croquettes reportee de 30min..", DISPLAY_TIME_SEC);
+      resultat = DISTRIBUTION_REPORTEE;
+      incrementerVersionEtat();
+      ecrans.showMessage("No gazou", "Gazou est absent, distribution des croquettes reportée de 30 min..", DISPLAY_TIME_SEC);
     }
     else
     { // Croquinettes
       DEBUG_PRINTLN("Pas de croquinettes pour les chats qui ne mangent pas");
-      oled.printMessage("No way", "Il y a deja des croquettes dans la gamelles !", DISPLAY_TIME_SEC);
+      resultat = REFUS_CROQUETTES_PRESENTES;
+      ecrans.showMessage("No way", "Il y a déjà des croquettes dans la gamelle !", DISPLAY_TIME_SEC);
     }
   }
   // Fin du CAS n°1 - Il y a déja des croquettes
@@ -356,7 +453,8 @@ void feedCat(boolean grossePortion)
   // CAS n°2 - Le régime n'est pas respecté
   else if (leRegimeEstRespecte == false)
   {
-    oled.printMessage("No Grazou", "Distribution annulee. Gazou a suffisamment mange aujourd'hui !", DISPLAY_TIME_SEC);
+    resultat = REFUS_REGIME;
+    ecrans.showMessage("No Grazou", "Distribution annulée. Gazou a suffisamment mangé aujourd'hui !", DISPLAY_TIME_SEC);
   }
   // Fin du CAS n°2 - Le régime n'est pas respecté
 
@@ -365,13 +463,16 @@ void feedCat(boolean grossePortion)
   {
     DEBUG_PRINT("Distribution ");
     // Afficher l'image du chat
-    oled.printImageCentered(IMAGE_CHAT, IMAGE_WIDTH, IMAGE_HEIGHT);
+    oled.printImageCentered(IMAGE_CHAT_PAGES.bitmap());
+    oled.waitFlush(); // Image visible pendant l'ouverture de la valve (bloquante)
+    ecrans.refresh(); // Puis retour à l'écran du gestionnaire
     //  Bonus: Prévenir le chat avec un son ou une led
 
     // CAS n°3a - Croquettes
     if (grossePortion == true)
     {
       DEBUG_PRINTLN(" des croquettes.");
+      resultat = DISTRIBUTION_CROQUETTES;
       openValve(CROQUETTES);                                   // Nourrir le chat avec une portion complète
       lastFeedTimeCroquettes = myRTC.getSecondsFromMidnight(); // Met à jour le dernier temps de nourrissage
       compteurDeCroquettes++;                                  // Mise à jour du compteur de croquettes
@@ -385,8 +486,9 @@ void feedCat(boolean grossePortion)
       preferences.putULong("croquetteTime", lastFeedTimeCroquettes);
       preferences.putUInt("compteurCroquette", compteurDeCroquettes);
       preferences.end(); // Ferme l'accès à la mémoire. C'est CRUCIAL.
+      incrementerVersionEtat();
 
-      oled.printMessage("Miam", "El Gazou a eu sa dose", DISPLAY_TIME_SEC);
+      ecrans.showMessage("Miam", "El Gazou a eu sa dose", DISPLAY_TIME_SEC);
       DEBUG_PRINTLN("El Gazou a eu sa dose");
     }
 
@@ -396,9 +498,10 @@ void feedCat(boolean grossePortion)
       DEBUG_PRINTLN(" des croquinettes.");
       // Vérifier que le delay des croquinettes est dépassé
       unsigned long deltaSecondes = myRTC.getSecondsFromMidnight() - lastFeedTimeCroquinettes; // interval de temps
-      if (deltaSecondes >= FEED_DELAY_CROQUINETTES_SEC)                                        // Si le délai de 30 min est écoulé
+      if (deltaSecondes >= feedDelayCroquinettesSec)                                        // Si le délai de 30 min est écoulé
       {
         DEBUG_PRINTLN("Délai écoulé, on peut donner une gourmandise/croquinette");
+        resultat = DISTRIBUTION_CROQUINETTES;
         openValve(CROQUINETTES);                                   // Nourrir le chat avec quelques croquettes
         lastFeedTimeCroquinettes = myRTC.getSecondsFromMidnight(); // Met à jour le dernier temps de gourmandise
         compteurDeCroquinettes++;                                  // Mise à jour du compteur de croquinettes
@@ -410,22 +513,56 @@ void feedCat(boolean grossePortion)
         preferences.putULong("croquinetteTime", lastFeedTimeCroquinettes);
         preferences.putUInt("compteurCroquinette", compteurDeCroquinettes);
         preferences.end(); // Ferme l'accès à la mémoire. C'est CRUCIAL.
+        incrementerVersionEtat();
 
         DEBUG_PRINTLN("El gazou est servi !");
-        oled.printMessage("Miaou", "El Gazou est servi !", DISPLAY_TIME_SEC);
+        ecrans.showMessage("Miaou", "El Gazou est servi !", DISPLAY_TIME_SEC);
       }
       else
       {
         DEBUG_PRINTLN("El gazou a deja eu sa gourmandise.");
+        resultat = REFUS_DELAI;
         char message[56];                                                       // Nombre de caractères max pour le message
         const unsigned int deltaMinutes = deltaSecondes / 60;                   // conversion en minutes
-        sprintf(message, "Dernieres Croquinettes il y a %d min", deltaMinutes); // Prépare le message à afficher
-        oled.printMessage("No way", message, DISPLAY_TIME_SEC);
+        sprintf(message, "Dernières Croquinettes il y a %d min", deltaMinutes); // Prépare le message à afficher
+        ecrans.showMessage("No way", message, DISPLAY_TIME_SEC);
       }
     }
   }
   // Fin du CAS n°3 - Il n'y a pas de croquettes et le régime est respecté
+
+  compteursDistribution[source][resultat]++;
+  return resultat;
 };
+
+int16_t executerCommande(const Command &commande)
+{
+  switch (commande.type)
+  {
+  case COMMANDE_DISTRIBUTION:
+    return feedCat(commande.arg != 0, (SourceCommande)commande.source);
+  default:
+    return -1;
+  }
+}
+
+void terminerCommande(const Command &commande)
+{
+  if (commande.state == COMMAND_COALESCED && commande.source == SOURCE_AUTO)
+  {
+    return; // Répétition du déclencheur automatique, pas une demande : ni comptée ni publiée
+  }
+  if (commande.state == COMMAND_COALESCED && commande.type == COMMANDE_DISTRIBUTION)
+  {
+    DEBUG_PRINTF("[Commandes] #%lu regroupée avec #%lu\n", (unsigned long)commande.id, (unsigned long)commande.coalescedInto);
+    compteursDistribution[commande.source][REFUS_DOUBLON]++;
+  }
+
+  char message[112];
+  BufferPrint out(message, sizeof(message));
+  ecrireCommandeJSON(out, commande);
+  evenements.send("command", message, out.length());
+}
 // -------------------       FONCTIONS: Nourir le chat (fin)       ------------------- /
 
 // -------------------       FONCTIONS: Setup boutons, mémoire et WiFi (début)       ------------------- /
@@ -452,8 +589,15 @@ void getSavedSettings()
   lastFeedTimeCroquinettes = preferences.getULong("croquinetteTime", 0); // 0 par défaut
   compteurDeCroquettes = preferences.getUInt("compteurCroquette", 0);
   compteurDeCroquinettes = preferences.getUInt("compteurCroquinette", 0);
+  rationQuotidienneG = preferences.getInt("ration", rationQuotidienneG);
+  rationCroquettesG = preferences.getInt("rationCroq", rationCroquettesG);
+  rationCroquinettesG = preferences.getInt("rationCroqui", rationCroquinettesG);
+  feedDelayCroquettesSec = preferences.getULong("delaiCroq", feedDelayCroquettesSec);
+  feedDelayCroquinettesSec = preferences.getULong("delaiCroqui", feedDelayCroquinettesSec);
+  snoozeDelaySec = preferences.getULong("snooze", snoozeDelaySec);
   preferences.end(); // Ferme l'accès à la mémoire. C'est CRUCIAL.
-  oled.printMessage("Memory", "Donnees recuperees depuis la memoire", DISPLAY_TIME_SEC);
+  incrementerVersionEtat();
+  ecrans.showMessage("Memory", "Données récupérées depuis la mémoire", DISPLAY_TIME_SEC);
 
   // DEBUG_PRINTLN("Données récupérées depuis la mémoire :");
   // char message[50];
@@ -462,24 +606,218 @@ void getSavedSettings()
   // sprintf(message, "Croquinettes : %02d - lastTime: %lu", compteurDeCroquinettes, lastFeedTimeCroquinettes);
   // DEBUG_PRINTLN(message);
 }
+
+/* Réglages groupés (POST /api/settings)
+Tous les champs sont validés sur une copie : au moindre refus, rien n'est modifié.
+Les champs acceptés sont ensuite appliqués ensemble, avec une seule ouverture des
+préférences et un seul message à l'écran.
+*/
+static boolean lireHeure(JsonVariantConst valeur, long &heure, long &minute)
+{
+  if (!valeur.is<const char *>())
+  {
+    return false;
+  }
+  int h, m;
+  if (sscanf(valeur.as<const char *>(), "%d:%d", &h, &m) != 2 || h < 0 || h > 23 || m < 0 || m > 59)
+  {
+    return false;
+  }
+  heure = h;
+  minute = m;
+  return true;
+}
+static boolean lireEntier(JsonVariantConst valeur, long minimum, long maximum, long &sortie)
+{
+  if (!valeur.is<long>())
+  {
+    return false;
+  }
+  const long v = valeur.as<long>();
+  if (v < minimum || v > maximum)
+  {
+    return false;
+  }
+  sortie = v;
+  return true;
+}
+const char *appliquerReglages(JsonObjectConst reglages)
+{
+  // Copie de travail
+  long debutH = heureDebutMiam, debutM = minuteDebutMiam;
+  long finH = heureFinMiam, finM = minuteFinMiam;
+  boolean autoMiam = autoMiamActivated;
+  long ration = rationQuotidienneG;
+  long rationCroquettes = rationCroquettesG;
+  long rationCroquinettes = rationCroquinettesG;
+  long delaiCroquettes = feedDelayCroquettesSec;
+  long delaiCroquinettes = feedDelayCroquinettesSec;
+  long snooze = snoozeDelaySec;
+  boolean plageModifiee = false;
+
+  for (JsonPairConst champ : reglages)
+  {
+    const char *cle = champ.key().c_str();
+    JsonVariantConst valeur = champ.value();
+    boolean valide;
+    if (strcmp(cle, "timeStart") == 0)
+    {
+      valide = lireHeure(valeur, debutH, debutM);
+      plageModifiee = true;
+    }
+    else if (strcmp(cle, "timeEnd") == 0)
+    {
+      valide = lireHeure(valeur, finH, finM);
+      plageModifiee = true;
+    }
+    else if (strcmp(cle, "autoMiam") == 0)
+    {
+      valide = valeur.is<bool>();
+      autoMiam = valeur.as<bool>();
+    }
+    else if (strcmp(cle, "ration") == 0)
+      valide = lireEntier(valeur, 1, 500, ration);
+    else if (strcmp(cle, "rationCroquettes") == 0)
+      valide = lireEntier(valeur, 1, 100, rationCroquettes);
+    else if (strcmp(cle, "rationCroquinettes") == 0)
+      valide = lireEntier(valeur, 1, 100, rationCroquinettes);
+    else if (strcmp(cle, "delayCroquettesSec") == 0)
+      valide = lireEntier(valeur, 60, 24 * 60 * 60L, delaiCroquettes);
+    else if (strcmp(cle, "delayCroquinettesSec") == 0)
+      valide = lireEntier(valeur, 10, 24 * 60 * 60L, delaiCroquinettes);
+    else if (strcmp(cle, "snoozeSec") == 0)
+      valide = lireEntier(valeur, 10, 24 * 60 * 60L, snooze);
+    else
+      valide = false; // Champ inconnu : probablement une faute de frappe
+    if (!valide)
+    {
+      DEBUG_PRINTF("[FitCat] Réglage refusé : %s\n", cle);
+      return cle;
+    }
+  }
+
+  // Cohérence de l'ensemble
+  // Ordre de la plage vérifié seulement si elle est modifiée : /setMiamTime règle une borne
+  // à la fois et peut laisser une plage inversée, qui ne doit pas bloquer les autres réglages
+  if (plageModifiee && debutH * 60 + debutM >= finH * 60 + finM)
+    return "timeEnd";
+  if (rationCroquettes > ration)
+    return "rationCroquettes";
+  if (rationCroquinettes > rationCroquettes)
+    return "rationCroquinettes";
+
+  // Application et persistance (seulement les valeurs modifiées)
+  preferences.begin("croquinator", false);
+  if (debutH != heureDebutMiam || debutM != minuteDebutMiam)
+  {
+    heureDebutMiam = debutH;
+    minuteDebutMiam = debutM;
+    preferences.putUInt("heureDebutMiam", heureDebutMiam);
+    preferences.putUInt("minuteDebutMiam", minuteDebutMiam);
+  }
+  if (finH != heureFinMiam || finM != minuteFinMiam)
+  {
+    heureFinMiam = finH;
+    minuteFinMiam = finM;
+    preferences.putUInt("heureFinMiam", heureFinMiam);
+    preferences.putUInt("minuteFinMiam", minuteFinMiam);
+  }
+  if (autoMiam != autoMiamActivated)
+  {
+    autoMiamActivated = autoMiam;
+    preferences.putBool("autoMiam", autoMiamActivated);
+  }
+  if (ration != rationQuotidienneG)
+  {
+    rationQuotidienneG = ration;
+    preferences.putInt("ration", rationQuotidienneG);
+  }
+  if (rationCroquettes != rationCroquettesG)
+  {
+    rationCroquettesG = rationCroquettes;
+    preferences.putInt("rationCroq", rationCroquettesG);
+  }
+  if (rationCroquinettes != rationCroquinettesG)
+  {
+    rationCroquinettesG = rationCroquinettes;
+    preferences.putInt("rationCroqui", rationCroquinettesG);
+  }
+  if ((unsigned long)delaiCroquettes != feedDelayCroquettesSec)
+  {
+    feedDelayCroquettesSec = delaiCroquettes;
+    delayDistributionCroquettesSec = feedDelayCroquettesSec; // Appliqué tout de suite, pas au prochain recalcul
+    preferences.putULong("delaiCroq", feedDelayCroquettesSec);
+  }
+  if ((unsigned long)delaiCroquinettes != feedDelayCroquinettesSec)
+  {
+    feedDelayCroquinettesSec = delaiCroquinettes;
+    preferences.putULong("delaiCroqui", feedDelayCroquinettesSec);
+  }
+  if ((unsigned long)snooze != snoozeDelaySec)
+  {
+    snoozeDelaySec = snooze;
+    preferences.putULong("snooze", snoozeDelaySec);
+  }
+  preferences.end(); // Ferme l'accès à la mémoire. C'est CRUCIAL.
+
+  masseEngloutieParLeChatEnG = calculerMasseEngloutie(); // Les rations ont pu changer
+  incrementerVersionEtat();
+  DEBUG_PRINTLN("[FitCat] Réglages mis à jour");
+  ecrans.showMessage("FitCat", "Réglages mis à jour.", DISPLAY_TIME_SEC);
+  return nullptr;
+}
 void setupWiFi()
 {
   // Initialiser WiFi
+  int8_t etape = chronoDemarrage.start("wifi.begin");
   wifi.begin();
+  chronoDemarrage.end(etape);
+  etape = chronoDemarrage.start("wifi.config");
   // wifi.setStateChangeCallback(onWiFiStateChange);
   wifi.setConnectionTimeout(30000);
-  wifi.setMaxReconnectAttempts(5);
+  wifi.setMaxReconnectAttempts(0);        // Ne jamais abandonner : backoff de 1 s à 5 min
+#ifdef WIFI_SSID_2
+  wifi.addNetwork(WIFI_SSID_2, WIFI_PASSWORD_2); // Répéteur ou box de secours (secrets.h)
+#endif
+  wifi.setRoaming(5 * 60 * 1000UL, 12);   // Changement d'AP si un AP connu est plus fort de 12 dB
+  wifi.enableNTP(NTP_SERVER, GMT_OFFSET_SEC, DAYLIGHT_OFFSET_SEC); // Synchro SNTP lancée à chaque connexion
+  chronoDemarrage.end(etape);
+
+  // Lancer la connexion : l'issue est traitée par gererDemarrage()
+  DEBUG_PRINTLN("Connexion WiFi en tâche de fond...");
+  ecrans.showMessage("WiFi", "Connexion au WiFi...", DISPLAY_TIME_SEC);
+  etapeLiaisonWifi = chronoDemarrage.start("wifi.link"); // Terminée par gererDemarrage() à la connexion
+  wifi.connectAsync();
+}
 
-  // Tenter la connexion
-  DEBUG_PRINT("Tentative de connexion WiFi...");
-  oled.printMessage("WiFi", "Connexion au WiFi...", DISPLAY_TIME_SEC);
-  if (!wifi.connect())
+// Suite du démarrage, à chaque passage dans loop() jusqu'à l'obtention de l'heure réseau
+void gererDemarrage()
+{
+  if (phasePreteMs[PHASE_NTP] != 0)
   {
+    return;
+  }
+
+  static bool pointAccesDemarre = false;
+  static bool echecNtpAffiche = false;
+  const WifiState etat = wifi.getState();
+
+  if (etat == WIFI_CONNECTED && phasePreteMs[PHASE_WIFI] == 0)
+  {
+    marquerPhase(PHASE_WIFI);
+    chronoDemarrage.end(etapeLiaisonWifi);
+    etapeNtp = chronoDemarrage.start("ntp");
+    DEBUG_PRINTLN("WiFi connected.");
+    ecrans.showMessage("WiFi", "WiFi connecté.", DISPLAY_TIME_SEC);
+  }
+  else if (etat == WIFI_CONNECTION_FAILED && phasePreteMs[PHASE_WIFI] == 0 && !pointAccesDemarre)
+  {
+    // Tous les réseaux connus ont échoué une fois : point d'accès de secours pour garder
+    // l'accès aux réglages. Les tentatives de connexion continuent en parallèle
+    pointAccesDemarre = true;
     DEBUG_PRINTLN("✗ Échec de connexion au WiFi principal");
     DEBUG_PRINTLN("→ Démarrage du mode Access Point de secours");
-    oled.printMessage("WiFi", "Echec de connexion au WiFi. Demarrage du mode Access Point...", DISPLAY_TIME_SEC);
-
-    // Démarrer en mode AP si échec de connexion
+    ecrans.showError("WiFi", "Échec de connexion au WiFi. Démarrage du mode Access Point...", DISPLAY_TIME_SEC);
     if (wifi.startAP(AP_SSID, AP_PASSWORD))
     {
       DEBUG_PRINTLN("✓ Mode AP activé");
@@ -487,42 +825,101 @@ void setupWiFi()
       DEBUG_PRINTLN(AP_SSID);
       DEBUG_PRINT("IP: ");
       DEBUG_PRINTLN(WiFi.softAPIP());
-      oled.printMessage("WiFi", "Mode AP active.", DISPLAY_TIME_SEC);
+      ecrans.showMessage("WiFi", "Mode AP activé.", DISPLAY_TIME_SEC);
     }
   }
-  else
-  {
-    DEBUG_PRINTLN("WiFi connected.");
-    oled.printMessage("WiFi", "WiFi connected.", DISPLAY_TIME_SEC);
 
-    // Activer NTP
-    wifi.enableNTP(NTP_SERVER, GMT_OFFSET_SEC, DAYLIGHT_OFFSET_SEC);
+  // Dès que le réseau ou le point d'accès est là ; sinon nouvel essai à la connexion
+  if (phasePreteMs[PHASE_WEB] == 0 && (wifi.isConnected() || (WiFi.getMode() & WIFI_AP) != 0))
+  {
+    demarrerServicesReseau();
   }
 
-  // Démarrer le serveur web
-  if (wifi.startWebServer(80))
+  // Heure réseau : SNTP lancé par le WiFiManager à la connexion, le RTC est recalé dès qu'elle arrive
+  if (phasePreteMs[PHASE_WIFI] != 0)
   {
-    setupWebRoutes();
-    DEBUG_PRINTLN("\n✓ Serveur web démarré");
-    oled.printMessage("WiFi", "Serveur web online.", DISPLAY_TIME_SEC);
-
-    if (wifi.isConnected())
+    if (time(nullptr) > 100000)
     {
-      DEBUG_PRINT("URL: http://");
-      DEBUG_PRINTLN(wifi.getIP());
+      syncRTCFromWiFi();
+      chronoDemarrage.end(etapeNtp);
+      marquerPhase(PHASE_NTP);
     }
-    else
+    else if (!echecNtpAffiche && millis() - phasePreteMs[PHASE_WIFI] > NTP_DELAI_MAX_MS)
     {
-      DEBUG_PRINT("URL AP: http://");
-      DEBUG_PRINTLN(WiFi.softAPIP());
+      echecNtpAffiche = true; // On continue d'attendre, sans répéter le message
+      ecrans.showError("Horloge", "Synchronisation RTC échouée car l'heure WiFi n'a pas pu être récupérée.", DISPLAY_TIME_SEC);
     }
   }
+}
+
+// Serveur web et OTA : une fois, sur le réseau ou sur le point d'accès de secours
+// PHASE_WEB n'est marquée que si le serveur a démarré : gererDemarrage() réessaie sinon
+bool demarrerServicesReseau()
+{
+  static int8_t etape = chronoDemarrage.start("services"); // Une seule étape, essais compris
+  if (!wifi.startWebServer(80))
+  {
+    return false;
+  }
+
+  setupWebRoutes();
+  DEBUG_PRINTLN("\n✓ Serveur web démarré");
+  ecrans.showMessage("WiFi", "Serveur web online.", DISPLAY_TIME_SEC);
+
+  if (wifi.isConnected())
+  {
+    DEBUG_PRINT("URL: http://");
+    DEBUG_PRINTLN(wifi.getIP());
+  }
+  else
+  {
+    DEBUG_PRINT("URL AP: http://");
+    DEBUG_PRINTLN(WiFi.softAPIP());
+  }
 
   // Initialisation du Service OTA
   if (!ota.begin())
   {
     DEBUG_PRINTLN(F("[Erreur] OTA non initialisé"));
   }
+  chronoDemarrage.end(etape);
+  marquerPhase(PHASE_WEB);
+  return true;
+}
+
+void marquerPhase(PhaseDemarrage phase)
+{
+  if (phasePreteMs[phase] != 0)
+  {
+    return;
+  }
+  phasePreteMs[phase] = millis() > 0 ? millis() : 1; // 0 est réservé aux phases pas encore prêtes
+  DEBUG_PRINTF("[Boot] %s prêt à %lu ms\n", NOMS_PHASES[phase], phasePreteMs[phase]);
+}
+
+// Première requête web servie, puis une seule écriture de la chronologie en flash : quand l'heure
+// réseau est obtenue et la première requête servie, ou au plus tard après CHRONO_DEMARRAGE_MAX_MS
+void suivreChronoDemarrage()
+{
+  if (chronoDemarrage.isSaved())
+  {
+    return;
+  }
+
+  static bool premiereRequete = false;
+  for (uint8_t i = 0; !premiereRequete && i < wifi.getRouteStatsCount(); i++)
+  {
+    if (wifi.getRouteStats(i).count > 0)
+    {
+      premiereRequete = true;
+      chronoDemarrage.mark("firstRequest");
+    }
+  }
+
+  if ((premiereRequete && phasePreteMs[PHASE_NTP] != 0) || millis() > CHRONO_DEMARRAGE_MAX_MS)
+  {
+    chronoDemarrage.save();
+  }
 }
 int getWiFiSignalLevel()
 {
@@ -556,71 +953,54 @@ int getWiFiSignalLevel()
 // Initialisation de l'écran OLED
 void setupScreen()
 {
+  oled.setI2CClock(OLED_I2C_CLOCK);
+  oled.setFlushBudget(OLED_FLUSH_BUDGET_US);
   if (!oled.begin())
   {
     DEBUG_PRINTLN("Erreur d'initialisation OLED !");
   }
   else
   {
+    ecrans.begin();
+    ecrans.setRenderer(SCREEN_HOME, displayHomeScreen);
+    ecrans.setRenderer(SCREEN_INFO, displayInfoScreen);
+
     DEBUG_PRINTLN("Chargement du système...");
-    for (int i = 0; i <= 100; i += 10)
-    {
-      oled.printImageWithProgress(IMAGE_CHAT, IMAGE_WIDTH, IMAGE_HEIGHT, i);
-      delay(50);
-    }
-    delay(100);
+    oled.printImageCentered(IMAGE_CHAT_PAGES.bitmap()); // Une image, sans attente : le démarrage continue
   }
 }
 
-void displayHomeScreen(unsigned int displayTimeSec)
+// Rendu des écrans déclarés : effacement et envoi faits par ScreenManager
+// Heure et compteurs copiés pour les écrans de bord (EcransOLED.h)
+DonneesEcrans lireDonneesEcrans()
 {
-  oled.clear();
-
-  // En-tête avec indicateur de WiFi
-  oled.printDate(myRTC.getDayOfMonth(), myRTC.getMonth(), myRTC.getYear(), ALIGN_LEFT, 0);
-  const int wifiSignal = getWiFiSignalLevel();
-  oled.drawWifiSignal(115, 0, wifiSignal);
-
-  // Heure actuelle
-  oled.printTime(myRTC.getHour(), myRTC.getMinute(), ALIGN_CENTER, 17, 2);
-
-  // Prochaine distribution
-  int prochainCroqSec = (lastFeedTimeCroquettes + delayDistributionCroquettesSec + compteurAbsenceChat * SNOOZE_DELAY_SEC);
-  oled.printTextAligned("Prochain croq:", ALIGN_LEFT, 40);
-  oled.printTextAligned(myRTC.formatSecondsToTime(prochainCroqSec, false), ALIGN_RIGHT, 40);
+  DonneesEcrans d;
+  d.jour = myRTC.getDayOfMonth();
+  d.mois = myRTC.getMonth();
+  d.annee = myRTC.getYear();
+  d.heure = myRTC.getHour();
+  d.minute = myRTC.getMinute();
+  d.signalWifi = getWiFiSignalLevel();
+  d.prochainesCroquettes = lastFeedTimeCroquettes + delayDistributionCroquettesSec + compteurAbsenceChat * snoozeDelaySec;
+  d.progression = masseEngloutieParLeChatEnG * 100 / rationQuotidienneG;
+  d.nbCroquettes = compteurDeCroquettes;
+  d.nbCroquinettes = compteurDeCroquinettes;
+  d.tCroquettes = lastFeedTimeCroquettes;
+  d.tCroquinettes = lastFeedTimeCroquinettes;
+  return d;
+}
 
-  // Barre de progression
-  const float progress = masseEngloutieParLeChatEnG * 100 / RATION_QUOTIDIENNE_G;
+void displayHomeScreen()
+{
+  const DonneesEcrans d = lireDonneesEcrans();
   DEBUG_PRINT("AutoFeed (%) : ");
-  DEBUG_PRINTLN(progress);
-  oled.drawProgressBarBottom(progress, true);
-
-  oled.refresh();
-  oled.startTimer(displayTimeSec);
+  DEBUG_PRINTLN(d.progression);
+  dessinerEcranAccueil(oled, d);
 }
 
-void displayInfoScreen(unsigned int displayTimeSec)
+void displayInfoScreen()
 {
-  const int wifiSignal = getWiFiSignalLevel();
-
-  oled.clear();
-
-  // En-tête avec indicateur de WiFi
-  oled.printText("Compteurs", 0, 0, 1);
-  oled.drawWifiSignal(115, 0, wifiSignal);
-
-  oled.printTextAligned("Croquettes", ALIGN_LEFT, 20);
-  oled.printValue(" - ", compteurDeCroquettes, 0, "", 30);
-  oled.printTextAligned(myRTC.formatSecondsToTime(lastFeedTimeCroquettes, false), ALIGN_RIGHT, 30);
-  // oled.printTime(8, 21, ALIGN_RIGHT, 26, 1);
-
-  oled.printTextAligned("Croquinettes", ALIGN_LEFT, 46);
-  oled.printValue(" - ", compteurDeCroquinettes, 0, "", 56);
-  oled.printTextAligned(myRTC.formatSecondsToTime(lastFeedTimeCroquinettes, false), ALIGN_RIGHT, 56);
-  // oled.printTime(8, 17, ALIGN_RIGHT, 56, 1);
-
-  oled.refresh();
-  oled.startTimer(displayTimeSec);
+  dessinerEcranInfo(oled, lireDonneesEcrans());
 }
 // -------------------       FONCTIONS: Ecran OLED (fin)      ------------------- /
 
@@ -633,7 +1013,7 @@ void setupRtc()
 
   //  Configurer la date
   // myRTC.setDateTime(0, 54, 22, 4, 11, 12, 2025);
-  syncRTCFromWiFi();
+  // Synchronisation NTP : par gererDemarrage(), dès que le WiFi a obtenu l'heure réseau
 
   // Afficher l'heure actuelle
   DEBUG_PRINTLN(F("\n--- Heure actuelle ---"));
@@ -658,22 +1038,22 @@ void setupRtc()
 }
 boolean syncRTCFromWiFi()
 {
-  oled.printMessage("Horloge", "Synchronisation de l'horloge RTC avec le WiFi..", DISPLAY_TIME_SEC);
+  ecrans.showMessage("Horloge", "Synchronisation de l'horloge RTC avec le WiFi..", DISPLAY_TIME_SEC);
   const bool isSync = myRTC.syncFromNTP(GMT_OFFSET_SEC, DAYLIGHT_OFFSET_SEC);
   if (myRTC.getYear() == 2000)
   {
     DEBUG_PRINTLN("Synchronisation RTC échouée, vérifier la batterie ou le branchement.");
-    oled.printMessage("Horloge", "Echec de synchronisation de l'heure RTC, verifier la batterie ou le branchement.", 15 * 60);
+    ecrans.showError("Horloge", "Échec de synchronisation de l'heure RTC, vérifier la batterie ou le branchement.", 15 * 60);
     return false;
   }
   if (isSync)
   {
-    oled.printMessage("Horloge", "Synchronisation de l'heure reussie", DISPLAY_TIME_SEC);
+    ecrans.showMessage("Horloge", "Synchronisation de l'heure réussie", DISPLAY_TIME_SEC);
     return true;
   }
   else
   {
-    oled.printMessage("Horloge", "Synchronisation RTC echouee car l'heure WiFi n'a pas pu etre recuperee.", DISPLAY_TIME_SEC);
+    ecrans.showError("Horloge", "Synchronisation RTC échouée car l'heure WiFi n'a pas pu être récupérée.", DISPLAY_TIME_SEC);
     return false;
   }
 }
@@ -685,51 +1065,117 @@ void setupWebRoutes()
   // Pages par défaut (home /status et /info)
   wifi.enableDefaultPages(true);
 
+  // Flux d'événements (SSE) : push des changements d'état vers le dashboard
+  evenements.begin(wifi.getServer(), "/api/events");
+
   // Dashboard page
   wifi.on("/dashboard", [](WebServerType &server)
-          { server.send(200, "text/html", DashboardPage::getHTML()); });
+          { server.send_P(200, PSTR("text/html"), DashboardPage::getHTML()); });
+
+  // En-têtes lus par les routes (If-None-Match pour les réponses 304)
+  const char *entetes[] = {"If-None-Match"};
+  wifi.getServer()->collectHeaders(entetes, 1);
 
   // API de données (Output pour l'UI)
+  // Corps mémorisé par version de l'état : une requête sans changement reçoit un 304 sans corps
+  // Les champs dépendant de "maintenant" sont calculés par le navigateur (voir /api/now)
   wifi.on("/api/data", [](WebServerType &server)
           {
              //DEBUG_PRINTLN("[Web] Nouvelle requête : /api/data");
+             static char cache[TAILLE_CACHE_DONNEES]; // Dernier corps JSON sérialisé
+             static size_t cacheLength = 0;
+             static unsigned long cacheVersion = 0;
+
+             char etag[24];
+             snprintf(etag, sizeof(etag), "\"%08lx-%lu\"", (unsigned long)identifiantDemarrage, etatVersion);
+             if (server.header("If-None-Match") == etag)
+             {
+               server.sendHeader("ETag", etag);
+               server.sendHeader("Cache-Control", "no-cache");
+               server.send(304);
+               return;
+             }
+
+             if (cacheVersion != etatVersion)
+             {
+               BufferPrint out(cache, sizeof(cache));
+               ecrireDonneesJSON(out);
+               if (out.overflowed())
+               {
+                 // Jamais de JSON tronqué : le cache reste invalide, la requête suivante réessaie
+                 DEBUG_PRINTLN("[Web] /api/data tronqué : augmenter TAILLE_CACHE_DONNEES");
+                 server.send(500, "text/plain", "Réponse trop longue pour le cache");
+                 return;
+               }
+               cacheLength = out.length();
+               cacheVersion = etatVersion;
+             }
+             server.sendHeader("ETag", etag);
+             server.sendHeader("Cache-Control", "no-cache");
+             server.send(200, "application/json", cache, cacheLength); });
+
+  // Historique : /api/history?since=<seq>&from=<s>&to=<s>&maxPoints=<n>
+  // - since : seuls les points ajoutés après seq (curseur inconnu, ex: après une remise à zéro => "reset":true)
+  // - from/to (secondes depuis minuit) et maxPoints : plage sous-échantillonnée sur l'ESP (LTTB),
+  //   la taille de la réponse ne dépend que de maxPoints. Toujours complet ("reset":true).
+  wifi.on("/api/history", [](WebServerType &server)
+          {
+             const unsigned long suivant = historySeqDebut + historySize;
+             const boolean plage = server.hasArg("from") || server.hasArg("to");
+             const unsigned long from = server.hasArg("from") ? strtoul(server.arg("from").c_str(), nullptr, 10) : 0;
+             const unsigned long to = server.hasArg("to") ? strtoul(server.arg("to").c_str(), nullptr, 10) : 86400UL; // Fin de journée
+             int maxPoints = MAX_HISTORY_POINTS;
+             if (server.hasArg("maxPoints"))
+             {
+               maxPoints = constrain(server.arg("maxPoints").toInt(), 2, MAX_HISTORY_POINTS);
+             }
 
-             const unsigned long maintenantSec = myRTC.getSecondsFromMidnight();
-             int dernieresCroquettes = maintenantSec - lastFeedTimeCroquettes;
-             int dernieresCroquinettes = (maintenantSec - lastFeedTimeCroquinettes);
-             int prochainCroq = (lastFeedTimeCroquettes + delayDistributionCroquettesSec + compteurAbsenceChat * SNOOZE_DELAY_SEC - maintenantSec);
-
-             JsonDocument doc;
-             doc["nbCroquettes"] = compteurDeCroquettes;
-             doc["nbCroquinettes"] = compteurDeCroquinettes;
-             doc["hCroquettes"] = myRTC.formatDuration(dernieresCroquettes);
-             doc["hCroquinettes"] = myRTC.formatDuration(dernieresCroquinettes);
-             doc["hNextCroquettes"] = myRTC.formatDuration(prochainCroq);
-             doc["delay"] = myRTC.formatDuration(delayDistributionCroquettesSec);
-             doc["mass"] = masseEngloutieParLeChatEnG;
-             doc["ration"] = RATION_QUOTIDIENNE_G;
-             doc["autoMiam"] = autoMiamActivated;
-
-             // Formatage de la plage horaire pour les inputs (ex: "07:30")
-             char timeBuf[6];
-             sprintf(timeBuf, "%02d:%02d", heureDebutMiam, minuteDebutMiam);
-             doc["timeStart"] = String(timeBuf);
-             sprintf(timeBuf, "%02d:%02d", heureFinMiam, minuteFinMiam);
-             doc["timeEnd"] = String(timeBuf);
-
-             // Ajout de l'historique au JSON
-             JsonArray hist = doc["history"].to<JsonArray>();
-             for (int i = 0; i < historySize; i++)
+             // Points dans la plage (l'historique est trié par heure)
+             int debut = 0;
+             int fin = historySize;
+             while (debut < fin && feedingHistory[debut].timestamp < from)
+               debut++;
+             while (fin > debut && feedingHistory[fin - 1].timestamp > to)
+               fin--;
+
+             // Incrémental seulement si le client peut tenir l'historique complet sans sous-échantillonnage
+             boolean complet = true;
+             if (!plage && historySize <= maxPoints && server.hasArg("since"))
+             {
+               const unsigned long since = strtoul(server.arg("since").c_str(), nullptr, 10);
+               if (since >= historySeqDebut && since <= suivant)
+               {
+                 debut = since - historySeqDebut;
+                 complet = false;
+               }
+             }
+
+             server.sendHeader("Cache-Control", "no-store");
+             ResponseWriter out(server);
+             out.begin(200, "application/json");
+             out.printf("{\"next\":%lu,\"reset\":%s,", suivant, complet ? "true" : "false");
+             if (complet)
+             {
+               uint8_t indices[MAX_HISTORY_POINTS];
+               const int nombre = echantillonnerHistorique(debut, fin, maxPoints, indices);
+               out.printf("\"sampled\":%s,\"points\":", nombre < fin - debut ? "true" : "false");
+               ecrireHistoriqueJSON(out, feedingHistory, indices, nombre);
+             }
+             else
              {
-               JsonObject point = hist.add<JsonObject>();
-               point["t"] = feedingHistory[i].timestamp;
-               point["m"] = feedingHistory[i].cumulativeMass;
+               out.print(F("\"sampled\":false,\"points\":"));
+               ecrireHistoriqueJSON(out, feedingHistory, debut, historySize);
              }
+             out.print('}');
+             out.end(); });
 
-             String output;
-             serializeJson(doc, output);
-             // DEBUG_PRINTLN(output);
-             server.send(200, "application/json", output); });
+  // Heure du distributeur : seule donnée qui évolue sans modification de l'état
+  wifi.on("/api/now", [](WebServerType &server)
+          {
+             char corps[24];
+             const int n = snprintf(corps, sizeof(corps), "{\"now\":%lu}", myRTC.getSecondsFromMidnight());
+             server.sendHeader("Cache-Control", "no-store");
+             server.send(200, "application/json", corps, n); });
 
   //  API de commandes (Input depuis l'UI)
   wifi.on("/setAutomiam", [](WebServerType &server)
@@ -742,14 +1188,64 @@ void setupWebRoutes()
   wifi.on("/feedCat", [](WebServerType &server)
           {
             DEBUG_PRINTLN("[Web] Nouvelle requête : /feedCat");
-        int val = server.arg("v").toInt();
-        feedCat(val);
-        server.send(200, "text/plain", "OK"); });
+        // La distribution est faite par loop() : réponse immédiate avec l'identifiant à suivre (/api/command)
+        const uint32_t id = commandes.enqueue(COMMANDE_DISTRIBUTION, server.arg("v").toInt() != 0, SOURCE_WEB);
+        if (id == 0)
+        {
+          server.send(503, "application/json", "{\"error\":\"queue\"}");
+          return;
+        }
+        // 202 : commande en file ; 409 : doublon d'une distribution récente, refusé (coalescedInto)
+        const Command &commande = *commandes.find(id);
+        char corps[112];
+        BufferPrint out(corps, sizeof(corps));
+        ecrireCommandeJSON(out, commande);
+        server.send(commande.state == COMMAND_COALESCED ? 409 : 202, "application/json", corps, out.length()); });
+
+  // Suivi d'une commande : /api/command?id=<id>
+  wifi.on("/api/command", [](WebServerType &server)
+          {
+        const Command *commande = commandes.find(strtoul(server.arg("id").c_str(), nullptr, 10));
+        if (commande == nullptr)
+        {
+          server.send(404, "application/json", "{\"error\":\"id\"}");
+          return;
+        }
+        char corps[112];
+        BufferPrint out(corps, sizeof(corps));
+        ecrireCommandeJSON(out, *commande);
+        server.sendHeader("Cache-Control", "no-store");
+        server.send(200, "application/json", corps, out.length()); });
   wifi.on("/reset", [](WebServerType &server)
           { 
             DEBUG_PRINTLN("[Web] Nouvelle requête : /reset");
           reinitialiserCompteurs();
           server.send(200, "text/plain", "OK"); });
+  // Réglages groupés : un objet JSON avec n'importe quel sous-ensemble des champs
+  // timeStart, timeEnd ("HH:MM"), autoMiam, ration, rationCroquettes, rationCroquinettes,
+  // delayCroquettesSec, delayCroquinettesSec, snoozeSec
+  // Tout est validé avant d'appliquer : une seule écriture en mémoire, un seul message OLED
+  wifi.on("/api/settings", HTTP_POST, [](WebServerType &server)
+          {
+            DEBUG_PRINTLN("[Web] Nouvelle requête : /api/settings");
+            char corps[64];
+            BufferPrint out(corps, sizeof(corps));
+
+            JsonDocument doc;
+            const DeserializationError erreurJSON = deserializeJson(doc, server.arg("plain"));
+            JsonObjectConst reglages = doc.as<JsonObjectConst>();
+            const char *refus = (erreurJSON || reglages.isNull()) ? "json" : appliquerReglages(reglages);
+            if (refus != nullptr)
+            {
+              out.print(F("{\"error\":"));
+              ResponseWriter::printJSONString(out, refus);
+              out.print('}');
+              server.send(400, "application/json", corps, out.length());
+              return;
+            }
+            out.printf("{\"version\":%lu}", etatVersion);
+            server.send(200, "application/json", corps, out.length()); });
+
   // Nouvelle route : Réglage des horaires
   wifi.on("/setMiamTime", [](WebServerType &server)
           {
@@ -770,8 +1266,49 @@ void setupWebRoutes()
   wifi.on("/scan", [](WebServerType &server)
           {
             DEBUG_PRINTLN("[Web] Nouvelle requête : /scan");
-            wifi.scanNetworks(); // 'wifi' doit être capturé ou global
-    server.send(200, "application/json", wifi.getScannedNetworkJSON()); });
+            // Jamais bloquant : cache récent => 200, sinon scan lancé en tâche de fond et 202
+            // avec les derniers résultats connus ; le client réessaie après Retry-After
+            const boolean frais = wifi.isScanFresh();
+            if (!frais)
+            {
+              wifi.startScan(); // Sans effet si un scan est déjà en cours
+              server.sendHeader("Retry-After", "3");
+            }
+            server.sendHeader("Cache-Control", "no-store");
+            ResponseWriter out(server);
+            out.begin(frais ? 200 : 202, "application/json");
+            wifi.writeScannedNetworkJSON(out);
+            out.end(); });
+
+  // Métriques au format texte Prometheus, écrites en flux (aucune allocation par scrape)
+  wifi.on("/metrics", [](WebServerType &server)
+          {
+            server.sendHeader("Cache-Control", "no-store");
+            ResponseWriter out(server);
+            out.begin(200, "text/plain; version=0.0.4; charset=utf-8");
+            ecrireMetriques(out);
+            out.end(); });
+
+  // Chronologie du démarrage courant et du précédent (µs), avec la raison du reset
+  wifi.on("/api/boot", [](WebServerType &server)
+          {
+            server.sendHeader("Cache-Control", "no-store");
+            ResponseWriter out(server);
+            out.begin(200, "application/json");
+            chronoDemarrage.writeJSON(out);
+            out.end(); });
+
+  // Image affichée par l'écran OLED (PBM), avec les octets I2C de la dernière image envoyée
+  wifi.on("/api/screen.pbm", [](WebServerType &server)
+          {
+            oled.waitFlush(); // Compteurs et image de l'écran, pas de l'envoi en cours
+            server.sendHeader("Cache-Control", "no-store");
+            server.sendHeader("X-OLED-Frames", String(oled.getFlushCount()));
+            server.sendHeader("X-OLED-Frame-Bytes", String(oled.getLastFlushBytes()));
+            ResponseWriter out(server);
+            out.begin(200, "image/x-portable-bitmap");
+            oled.writePBM(out);
+            out.end(); });
 
   // Redémarrer l'ESP
   wifi.on("/restart", [](WebServerType &server)
@@ -781,4 +1318,401 @@ void setupWebRoutes()
   delay(1000);
   ESP.restart(); });
 }
-// -------------------       WEBROUTES (fin)       ------------------- /
\ No newline at end of file
+// -------------------       WEBROUTES (fin)       ------------------- /
+
+// -------------------       EVENEMENTS SSE (début)       ------------------- /
+void incrementerVersionEtat()
+{
+  etatVersion++;
+}
+
+/* Pousse aux dashboards connectés un delta de l'état (clés identiques à /api/data)
+Seuls les champs modifiés sont envoyés, avec la version comme id d'événement.
+L'heure du distributeur ("now") est poussée toutes les SSE_TICK_MS pour recaler
+les décomptes calculés par le navigateur.
+*/
+void publierEtat()
+{
+  static unsigned long dernierControle = 0;
+  static unsigned long dernierTick = 0;
+  static unsigned long versionPubliee = 0;
+  static EtatPublie publie = {};
+  static char tampon[768]; // Message SSE (statique : hors pile et hors tas)
+
+  if (millis() - dernierControle < SSE_CONTROLE_MS)
+  {
+    return;
+  }
+  dernierControle = millis();
+
+  const boolean tick = millis() - dernierTick >= SSE_TICK_MS;
+  if (etatVersion == versionPubliee && !tick)
+  {
+    return; // Rien de nouveau
+  }
+
+  EtatPublie actuel;
+  actuel.nbCroquettes = compteurDeCroquettes;
+  actuel.nbCroquinettes = compteurDeCroquinettes;
+  actuel.lastCroquettes = lastFeedTimeCroquettes;
+  actuel.lastCroquinettes = lastFeedTimeCroquinettes;
+  actuel.delay = delayDistributionCroquettesSec;
+  actuel.absences = compteurAbsenceChat;
+  actuel.snooze = snoozeDelaySec;
+  actuel.ration = rationQuotidienneG;
+  actuel.mass = masseEngloutieParLeChatEnG;
+  actuel.autoMiam = autoMiamActivated;
+  actuel.debutMiam = heureDebutMiam * 60 + minuteDebutMiam;
+  actuel.finMiam = heureFinMiam * 60 + minuteFinMiam;
+  actuel.historySeq = historySeqDebut + historySize;
+
+  if (evenements.getClientCount() == 0)
+  {
+    publie = actuel; // Personne à prévenir : les nouveaux clients lisent /api/data
+    versionPubliee = etatVersion;
+    return;
+  }
+
+  BufferPrint out(tampon, sizeof(tampon));
+
+  if (tick)
+  {
+    out.printf("{\"now\":%lu}", myRTC.getSecondsFromMidnight());
+    evenements.send("now", out.c_str(), out.length());
+    dernierTick = millis();
+    out.reset();
+  }
+  if (etatVersion == versionPubliee)
+  {
+    return;
+  }
+
+  boolean premier = true;
+  out.print('{');
+  ecrireCle(out, premier, "version");
+  out.print(etatVersion);
+
+  if (actuel.nbCroquettes != publie.nbCroquettes)
+  {
+    ecrireCle(out, premier, "nbCroquettes");
+    out.print(actuel.nbCroquettes);
+  }
+  if (actuel.nbCroquinettes != publie.nbCroquinettes)
+  {
+    ecrireCle(out, premier, "nbCroquinettes");
+    out.print(actuel.nbCroquinettes);
+  }
+  if (actuel.mass != publie.mass)
+  {
+    ecrireCle(out, premier, "mass");
+    out.print(actuel.mass);
+  }
+  if (actuel.ration != publie.ration)
+  {
+    ecrireCle(out, premier, "ration");
+    out.print(actuel.ration);
+  }
+  if (actuel.autoMiam != publie.autoMiam)
+  {
+    ecrireCle(out, premier, "autoMiam");
+    out.print(actuel.autoMiam ? F("true") : F("false"));
+  }
+  if (actuel.debutMiam != publie.debutMiam)
+  {
+    ecrireCle(out, premier, "timeStart");
+    out.printf("\"%02d:%02d\"", heureDebutMiam, minuteDebutMiam);
+  }
+  if (actuel.finMiam != publie.finMiam)
+  {
+    ecrireCle(out, premier, "timeEnd");
+    out.printf("\"%02d:%02d\"", heureFinMiam, minuteFinMiam);
+  }
+  if (actuel.lastCroquettes != publie.lastCroquettes)
+  {
+    ecrireCle(out, premier, "tCroquettes");
+    out.print(actuel.lastCroquettes);
+  }
+  if (actuel.lastCroquinettes != publie.lastCroquinettes)
+  {
+    ecrireCle(out, premier, "tCroquinettes");
+    out.print(actuel.lastCroquinettes);
+  }
+  if (actuel.delay != publie.delay)
+  {
+    ecrireCle(out, premier, "delaySec");
+    out.print(actuel.delay);
+  }
+  if (actuel.lastCroquettes != publie.lastCroquettes || actuel.delay != publie.delay ||
+      actuel.absences != publie.absences || actuel.snooze != publie.snooze)
+  {
+    ecrireCle(out, premier, "tNextCroquettes");
+    out.print(actuel.lastCroquettes + actuel.delay + actuel.absences * actuel.snooze);
+  }
+
+  // Historique : seul le curseur est poussé, les points sont lus sur /api/history?since=
+  if (actuel.historySeq != publie.historySeq)
+  {
+    ecrireCle(out, premier, "hSeq");
+    out.print(actuel.historySeq);
+  }
+  out.print('}');
+
+  publie = actuel;
+  versionPubliee = etatVersion;
+  if (out.overflowed())
+  {
+    DEBUG_PRINTLN("[SSE] Message trop long, les clients se resynchronisent");
+    evenements.send("resync", "{}");
+    return;
+  }
+  evenements.send("state", out.c_str(), out.length(), etatVersion);
+}
+
+void ecrireCle(Print &out, boolean &premier, const char *cle)
+{
+  if (!premier)
+  {
+    out.print(',');
+  }
+  premier = false;
+  out.print('"');
+  out.print(cle);
+  out.print(F("\":"));
+}
+
+// État complet (/api/data) : copie des globales, sérialisée par DonneesJSON.h
+void ecrireDonneesJSON(Print &out)
+{
+  DonneesDistributeur donnees;
+  donnees.version = etatVersion;
+  donnees.nbCroquettes = compteurDeCroquettes;
+  donnees.nbCroquinettes = compteurDeCroquinettes;
+  donnees.tCroquettes = lastFeedTimeCroquettes;
+  donnees.tCroquinettes = lastFeedTimeCroquinettes;
+  donnees.delaySec = delayDistributionCroquettesSec;
+  donnees.absences = compteurAbsenceChat;
+  donnees.snoozeSec = snoozeDelaySec;
+  donnees.mass = masseEngloutieParLeChatEnG;
+  donnees.ration = rationQuotidienneG;
+  donnees.autoMiam = autoMiamActivated;
+  donnees.heureDebut = heureDebutMiam;
+  donnees.minuteDebut = minuteDebutMiam;
+  donnees.heureFin = heureFinMiam;
+  donnees.minuteFin = minuteFinMiam;
+  donnees.hSeq = historySeqDebut + historySize;
+  ecrireDonneesJSON(out, donnees);
+}
+
+/* Sous-échantillonnage Largest-Triangle-Three-Buckets des points [debut, fin[
+Conserve le premier et le dernier point, puis dans chaque seau le point qui forme
+le plus grand triangle avec le point retenu précédent et la moyenne du seau suivant :
+la forme de la courbe (paliers, montées) survit à la réduction.
+Retourne le nombre d'indices écrits (<= maxPoints).
+*/
+int echantillonnerHistorique(int debut, int fin, int maxPoints, uint8_t *indices)
+{
+  const int n = fin - debut;
+  if (n <= 0)
+  {
+    return 0;
+  }
+  if (n <= maxPoints || maxPoints < 3)
+  {
+    const int nombre = (n <= maxPoints) ? n : maxPoints;
+    for (int i = 0; i < nombre; i++)
+    {
+      indices[i] = (i == nombre - 1) ? fin - 1 : debut + i; // maxPoints < 3 : premier et dernier
+    }
+    return nombre;
+  }
+
+  const float taille = (float)(n - 2) / (maxPoints - 2); // Points par seau (hors extrémités)
+  int nombre = 0;
+  int retenu = debut;
+  indices[nombre++] = retenu;
+
+  for (int seau = 0; seau < maxPoints - 2; seau++)
+  {
+    // Moyenne du seau suivant (ou dernier point)
+    int suivantDebut = debut + 1 + (int)((seau + 1) * taille);
+    int suivantFin = debut + 1 + (int)((seau + 2) * taille);
+    if (suivantFin > fin)
+      suivantFin = fin;
+    if (suivantDebut >= suivantFin)
+      suivantDebut = suivantFin - 1;
+    float moyenneT = 0;
+    float moyenneM = 0;
+    for (int i = suivantDebut; i < suivantFin; i++)
+    {
+      moyenneT += feedingHistory[i].timestamp;
+      moyenneM += feedingHistory[i].cumulativeMass;
+    }
+    moyenneT /= (suivantFin - suivantDebut);
+    moyenneM /= (suivantFin - suivantDebut);
+
+    // Point du seau courant formant le plus grand triangle
+    const int courantDebut = debut + 1 + (int)(seau * taille);
+    const int courantFin = debut + 1 + (int)((seau + 1) * taille);
+    const float tA = feedingHistory[retenu].timestamp;
+    const float mA = feedingHistory[retenu].cumulativeMass;
+    float aireMax = -1;
+    int meilleur = courantDebut;
+    for (int i = courantDebut; i < courantFin; i++)
+    {
+      const float aire = fabsf((tA - moyenneT) * (feedingHistory[i].cumulativeMass - mA) -
+                               (tA - feedingHistory[i].timestamp) * (moyenneM - mA));
+      if (aire > aireMax)
+      {
+        aireMax = aire;
+        meilleur = i;
+      }
+    }
+    retenu = meilleur;
+    indices[nombre++] = retenu;
+  }
+
+  indices[nombre++] = fin - 1;
+  return nombre;
+}
+// -------------------       EVENEMENTS SSE (fin)       ------------------- /
+
+// -------------------       COMMANDES (début)       ------------------- /
+void ecrireCommandeJSON(Print &out, const Command &commande)
+{
+  out.printf("{\"id\":%lu,\"state\":\"%s\"", (unsigned long)commande.id, CommandQueue::stateName(commande.state));
+  if (commande.source < NB_SOURCES)
+  {
+    out.printf(",\"source\":\"%s\"", NOMS_SOURCES[commande.source]);
+  }
+  if (commande.state == COMMAND_DONE && commande.result >= 0 && commande.result < NB_RESULTATS)
+  {
+    out.printf(",\"result\":\"%s\"", NOMS_RESULTATS[commande.result]);
+  }
+  else if (commande.state == COMMAND_COALESCED)
+  {
+    out.printf(",\"result\":\"%s\",\"into\":%lu", NOMS_RESULTATS[REFUS_DOUBLON], (unsigned long)commande.coalescedInto);
+  }
+  out.print('}');
+}
+// -------------------       COMMANDES (fin)       ------------------- /
+
+// -------------------       METRIQUES (début)       ------------------- /
+uint64_t millis64()
+{
+  static uint32_t dernier = 0;
+  static uint32_t debordements = 0;
+  const uint32_t maintenant = millis();
+  if (maintenant < dernier)
+  {
+    debordements++;
+  }
+  dernier = maintenant;
+  return ((uint64_t)debordements << 32) | maintenant;
+}
+
+/* Exposition Prometheus (format texte 0.0.4)
+Tout est écrit directement dans out : le coût d'un scrape ne dépend pas du tas
+*/
+void ecrireMetriques(Print &out)
+{
+  PrometheusWriter prom(out);
+
+  // Système
+  prom.family("croquinator_uptime_seconds", "counter", "Temps depuis le démarrage");
+  prom.sample("croquinator_uptime_seconds").value((unsigned long long)(millis64() / 1000));
+  prom.gauge("croquinator_heap_free_bytes", "Tas libre", (long)ESP.getFreeHeap());
+  prom.gauge("croquinator_heap_max_block_bytes", "Plus grand bloc libre du tas", (long)ESP.getMaxFreeBlockSize());
+  prom.gauge("croquinator_heap_fragmentation_percent", "Fragmentation du tas", (long)ESP.getHeapFragmentation());
+  prom.gauge("croquinator_wifi_connected", "WiFi connecté (1) ou non (0)", (long)wifi.isConnected());
+  prom.gauge("croquinator_wifi_rssi_dbm", "Puissance du signal WiFi", wifi.isConnected() ? (float)wifi.getRSSI() : NAN, 0);
+  int8_t rssiMin, rssiMediane, rssiMax;
+  const bool rssiHistorique = wifi.getRSSIStats(rssiMin, rssiMediane, rssiMax) > 0;
+  prom.gauge("croquinator_wifi_rssi_median_dbm", "Médiane des derniers échantillons RSSI", rssiHistorique ? (float)rssiMediane : NAN, 0);
+  prom.counter("croquinator_wifi_outages_total", "Coupures WiFi depuis le démarrage", wifi.getOutageCount());
+  prom.counter("croquinator_wifi_outage_seconds_total", "Durée cumulée des coupures WiFi", wifi.getOutageTotalMs() / 1000UL);
+  prom.counter("croquinator_oled_flushes_total", "Envois vers l'écran OLED", oled.getFlushCount());
+  prom.counter("croquinator_oled_bytes_total", "Octets de données I2C envoyés à l'écran OLED", oled.getFlushBytesTotal());
+  prom.counter("croquinator_oled_compared_bytes_total", "Octets dessinés comparés à l'image affichée", oled.getComparedBytes());
+  prom.counter("croquinator_oled_skipped_bytes_total", "Octets identiques à l'image affichée, non envoyés", oled.getSkippedBytes());
+  prom.gauge("croquinator_oled_last_flush_bytes", "Octets du dernier envoi OLED", (long)oled.getLastFlushBytes());
+  prom.gauge("croquinator_oled_flush_max_seconds", "Durée maximale d'un envoi OLED", oled.getMaxFlushUs() / 1e6f);
+  prom.gauge("croquinator_oled_update_max_seconds", "Plus long envoi OLED fait par un passage dans loop()", oled.getMaxUpdateUs() / 1e6f);
+  prom.family("croquinator_boot_phase_seconds", "gauge", "Temps de démarrage jusqu'à la fin de chaque phase (NaN : pas encore prête)");
+  for (uint8_t phase = 0; phase < NB_PHASES; phase++)
+  {
+    prom.sample("croquinator_boot_phase_seconds").label("phase", NOMS_PHASES[phase]).value(phasePreteMs[phase] != 0 ? phasePreteMs[phase] / 1000.0f : NAN, 3);
+  }
+  prom.summary("croquinator_loop_interval_seconds", "Intervalle entre deux passages dans loop()", latenceBoucle);
+  prom.gauge("croquinator_loop_interval_max_seconds", "Intervalle maximum entre deux passages dans loop()", latenceBoucle.getMaxUs() / 1e6f);
+
+  // Distributions par origine et par issue (reportee = snooze, refus_* = refus)
+  prom.family("croquinator_feed_requests_total", "counter", "Demandes de distribution par origine et par issue");
+  for (uint8_t source = 0; source < NB_SOURCES; source++)
+  {
+    for (uint8_t resultat = 0; resultat < NB_RESULTATS; resultat++)
+    {
+      prom.sample("croquinator_feed_requests_total")
+          .label("source", NOMS_SOURCES[source])
+          .label("result", NOMS_RESULTATS[resultat])
+          .value(compteursDistribution[source][resultat]);
+    }
+  }
+  prom.gauge("croquinator_commands_pending", "Commandes en attente d'exécution", (long)commandes.getPendingCount());
+  prom.counter("croquinator_commands_coalesced_total", "Commandes refusées car identiques à une commande récente", commandes.getCoalescedCount());
+  prom.counter("croquinator_commands_overflow_total", "Commandes refusées car la file est pleine", commandes.getOverflowCount());
+  prom.gauge("croquinator_eaten_grams", "Masse distribuée aujourd'hui", (long)masseEngloutieParLeChatEnG);
+  prom.counter("croquinator_servo_attaches_total", "Attachements du servomoteur (PWM active)", monServomoteur.getAttachCount());
+  prom.counter("croquinator_servo_attached_seconds_total", "Durée cumulée avec le servomoteur attaché", monServomoteur.getAttachedMs() / 1000UL);
+  prom.gauge("croquinator_servo_attached", "Servomoteur attaché (1) ou non (0)", (long)monServomoteur.isAttached());
+  prom.counter("croquinator_flash_writes_total", "Écritures en mémoire persistante depuis le démarrage", preferences.getEcritures());
+
+  // Requêtes HTTP par route (durée du handler, envoi de la réponse compris)
+  const uint8_t nbRoutes = wifi.getRouteStatsCount();
+  prom.family("croquinator_http_requests_total", "counter", "Requêtes HTTP par route");
+  for (uint8_t i = 0; i < nbRoutes; i++)
+  {
+    const RouteStats &route = wifi.getRouteStats(i);
+    prom.sample("croquinator_http_requests_total").label("route", route.uri).value((unsigned long)route.count);
+  }
+  prom.family("croquinator_http_request_duration_seconds", "summary", "Durée de traitement des requêtes HTTP par route");
+  for (uint8_t i = 0; i < nbRoutes; i++)
+  {
+    const RouteStats &route = wifi.getRouteStats(i);
+    prom.sample("croquinator_http_request_duration_seconds", "_sum").label("route", route.uri).value((float)(route.totalUs / 1e6), 6);
+    prom.sample("croquinator_http_request_duration_seconds", "_count").label("route", route.uri).value((unsigned long)route.count);
+  }
+  prom.family("croquinator_http_request_duration_max_seconds", "gauge", "Durée maximum de traitement par route");
+  for (uint8_t i = 0; i < nbRoutes; i++)
+  {
+    const RouteStats &route = wifi.getRouteStats(i);
+    prom.sample("croquinator_http_request_duration_max_seconds").label("route", route.uri).value(route.maxUs / 1e6f);
+  }
+#ifdef WIFI_MANAGER_MULTI_CLIENT
+  prom.gauge("croquinator_http_connections", "Connexions HTTP ouvertes", (long)wifi.getServer()->getActiveConnections());
+  prom.counter("croquinator_http_timeouts_total", "Requêtes incomplètes abandonnées (408)", wifi.getServer()->getTimeoutCount());
+  prom.counter("croquinator_http_rejected_total", "Connexions ou requêtes refusées", wifi.getServer()->getRejectedCount());
+#endif
+  prom.gauge("croquinator_sse_clients", "Dashboards connectés en SSE", (long)evenements.getClientCount());
+  prom.counter("croquinator_sse_dropped_total", "Clients SSE trop lents déconnectés", evenements.getDroppedCount());
+
+  // Horloge : écart NTP - RTC mesuré à la dernière synchronisation
+  const boolean synchronise = myRTC.getSyncCount() > 0;
+  prom.gauge("croquinator_ntp_offset_seconds", "Écart NTP - RTC avant la dernière synchronisation",
+             synchronise ? (float)myRTC.getLastSyncOffset() : NAN, 0);
+  prom.gauge("croquinator_ntp_last_sync_age_seconds", "Temps depuis la dernière synchronisation NTP",
+             synchronise ? (float)((millis() - myRTC.getLastSyncMillis()) / 1000UL) : NAN, 0);
+  prom.counter("croquinator_ntp_syncs_total", "Synchronisations NTP réussies", myRTC.getSyncCount());
+
+  // OTA : un échantillon par état, 1 pour l'état courant
+  static const char *const etatsOTA[] = {"idle", "ready", "updating", "success", "error"};
+  const int etatCourant = static_cast<int>(ota.getState());
+  prom.family("croquinator_ota_state", "gauge", "État de la mise à jour OTA");
+  for (int i = 0; i < 5; i++)
+  {
+    prom.sample("croquinator_ota_state").label("state", etatsOTA[i]).value(i == etatCourant ? 1 : 0);
+  }
+  prom.gauge("croquinator_ota_progress_percent", "Progression de la mise à jour OTA", (long)ota.getProgressPercent());
+
+  prom.counter("croquinator_state_version", "Version de l'état (incrémentée à chaque modification)", etatVersion);
+}
+// -------------------       METRIQUES (fin)       ------------------- /
\ No newline at end of file
@@ -0,0 +1,69 @@
+/*
+ * Adafruit_GFX.h (tests sur PC)
+ * Primitives d'Adafruit_GFX utilisées par OLEDDisplay, avec le même tracé pixel par pixel
+ * (drawBitmap : lignes de (w + 7) / 8 octets, bit de poids fort à gauche)
+ */
+
+#ifndef NATIVE_ADAFRUIT_GFX_H
+#define NATIVE_ADAFRUIT_GFX_H
+
+#include <Arduino.h>
+
+class Adafruit_GFX
+{
+public:
+    Adafruit_GFX(int16_t w, int16_t h) : WIDTH(w), HEIGHT(h) {}
+    virtual ~Adafruit_GFX() {}
+
+    virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+
+    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+    {
+        for (int16_t i = 0; i < w; i++)
+            drawPixel(x + i, y, color);
+    }
+    void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+    {
+        for (int16_t j = 0; j < h; j++)
+            drawPixel(x, y + j, color);
+    }
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+    {
+        for (int16_t i = 0; i < w; i++)
+            drawFastVLine(x + i, y, h, color);
+    }
+    void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+    {
+        drawFastHLine(x, y, w, color);
+        drawFastHLine(x, y + h - 1, w, color);
+        drawFastVLine(x, y, h, color);
+        drawFastVLine(x + w - 1, y, h, color);
+    }
+    void drawBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h, uint16_t color)
+    {
+        const int16_t byteWidth = (w + 7) / 8;
+        uint8_t b = 0;
+        for (int16_t j = 0; j < h; j++)
+        {
+            for (int16_t i = 0; i < w; i++)
+            {
+                if (i & 7)
+                    b <<= 1;
+                else
+                    b = pgm_read_byte(&bitmap[j * byteWidth + i / 8]);
+                if (b & 0x80)
+                    drawPixel(x + i, y + j, color);
+            }
+        }
+    }
+    void setTextColor(uint16_t c) { textcolor = c; }
+    int16_t width() const { return WIDTH; }
+    int16_t height() const { return HEIGHT; }
+
+protected:
+    const int16_t WIDTH;
+    const int16_t HEIGHT;
+    uint16_t textcolor = 1;
+};
+
+#endif // NATIVE_ADAFRUIT_GFX_H
@@ -0,0 +1,98 @@
+/*
+ * Adafruit_SSD1306.h (tests sur PC)
+ * Buffer de composition au format des pages (x + (y / 8) * largeur, bit y % 8), comme la
+ * bibliothèque Adafruit. display() envoie l'écran complet sur Wire de la même façon :
+ * fenêtre pleine page 0-7 / colonnes 0-127, puis données par transactions de 31 octets
+ */
+
+#ifndef NATIVE_ADAFRUIT_SSD1306_H
+#define NATIVE_ADAFRUIT_SSD1306_H
+
+#include <Arduino.h>
+#include <Adafruit_GFX.h>
+#include <Wire.h>
+
+#define BLACK 0
+#define WHITE 1
+#define INVERSE 2
+#define SSD1306_BLACK BLACK
+#define SSD1306_WHITE WHITE
+
+#define SSD1306_SWITCHCAPVCC 0x02
+#define SSD1306_SETCONTRAST 0x81
+#define SSD1306_DISPLAYOFF 0xAE
+#define SSD1306_DISPLAYON 0xAF
+#define SSD1306_MEMORYMODE 0x20
+#define SSD1306_COLUMNADDR 0x21
+#define SSD1306_PAGEADDR 0x22
+
+class Adafruit_SSD1306 : public Adafruit_GFX
+{
+public:
+    Adafruit_SSD1306(uint8_t w, uint8_t h, TwoWire *twi = &Wire, int8_t = -1)
+        : Adafruit_GFX(w, h), wire(twi) {}
+    ~Adafruit_SSD1306() { free(buffer); }
+
+    bool begin(uint8_t = SSD1306_SWITCHCAPVCC, uint8_t addr = 0x3C, bool = true, bool = true)
+    {
+        if (buffer == nullptr && (buffer = (uint8_t *)malloc(WIDTH * ((HEIGHT + 7) / 8))) == nullptr)
+            return false;
+        i2caddr = addr;
+        clearDisplay();
+        ssd1306_command(SSD1306_DISPLAYOFF);
+        ssd1306_command(SSD1306_MEMORYMODE);
+        ssd1306_command(0x00); // Adressage horizontal
+        ssd1306_command(SSD1306_DISPLAYON);
+        return true;
+    }
+
+    void clearDisplay() { memset(buffer, 0, WIDTH * ((HEIGHT + 7) / 8)); }
+    uint8_t *getBuffer() { return buffer; }
+
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override
+    {
+        if (x < 0 || x >= WIDTH || y < 0 || y >= HEIGHT)
+            return;
+        uint8_t &target = buffer[x + (y / 8) * WIDTH];
+        if (color == WHITE)
+            target |= (1 << (y & 7));
+        else if (color == BLACK)
+            target &= ~(1 << (y & 7));
+        else
+            target ^= (1 << (y & 7));
+    }
+
+    void ssd1306_command(uint8_t c)
+    {
+        wire->beginTransmission(i2caddr);
+        wire->write((uint8_t)0x00);
+        wire->write(c);
+        wire->endTransmission();
+    }
+
+    void display()
+    {
+        const uint8_t commands[] = {0x00, SSD1306_PAGEADDR, 0, 0xFF, SSD1306_COLUMNADDR, 0, (uint8_t)(WIDTH - 1)};
+        wire->beginTransmission(i2caddr);
+        wire->write(commands, sizeof(commands));
+        wire->endTransmission();
+
+        const uint16_t total = WIDTH * ((HEIGHT + 7) / 8);
+        for (uint16_t sent = 0; sent < total;)
+        {
+            const uint16_t chunk = (total - sent > 31) ? 31 : total - sent;
+            wire->beginTransmission(i2caddr);
+            wire->write((uint8_t)0x40);
+            wire->write(buffer + sent, chunk);
+            wire->endTransmission();
+            sent += chunk;
+        }
+    }
+
+private:
+    TwoWire *wire;
+    uint8_t *buffer = nullptr;
+    uint8_t i2caddr = 0x3C;
+};
+
+#endif // NATIVE_ADAFRUIT_SSD1306_H
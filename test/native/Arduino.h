@@ -0,0 +1,140 @@
+/*
+ * Arduino.h (tests sur PC)
+ * Sous-ensemble du core ESP8266 utilisé par le code testé avec pio test -e native
+ * - Print : mêmes surcharges et même tampon de 64 octets pour printf
+ * - F(), PROGMEM, pgm_read_byte : mémoire ordinaire
+ * - millis(), micros() : horloge du PC
+ * - String : enveloppe de std::string (seules les surcharges String des bibliothèques s'en servent)
+ */
+
+#ifndef NATIVE_ARDUINO_H
+#define NATIVE_ARDUINO_H
+
+#include <stdint.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <string>
+
+typedef bool boolean;
+
+// -------------------- Mémoire programme --------------------
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper *>(s))
+#define PSTR(s) (s)
+#define PROGMEM
+#define PGM_P const char *
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define strlen_P strlen
+#define memcpy_P memcpy
+
+// -------------------- Temps --------------------
+inline unsigned long micros()
+{
+    static const auto debut = std::chrono::steady_clock::now();
+    return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now() - debut)
+        .count();
+}
+inline unsigned long millis() { return micros() / 1000; }
+inline void yield() {}
+inline void delay(unsigned long) {}
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+inline char *dtostrf(double value, signed char width, unsigned char precision, char *buffer)
+{
+    sprintf(buffer, "%*.*f", width, precision, value);
+    return buffer;
+}
+
+// -------------------- String --------------------
+class String
+{
+public:
+    String(const char *text = "") : text(text != nullptr ? text : "") {}
+    String(const std::string &text) : text(text) {}
+    const char *c_str() const { return text.c_str(); }
+    unsigned int length() const { return text.length(); }
+    bool operator==(const char *other) const { return text == other; }
+    bool operator==(const String &other) const { return text == other.text; }
+
+private:
+    std::string text;
+};
+
+// -------------------- Print --------------------
+class Print
+{
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size)
+    {
+        size_t n = 0;
+        while (size--)
+            n += write(*buffer++);
+        return n;
+    }
+    size_t write(const char *str) { return str ? write((const uint8_t *)str, strlen(str)) : 0; }
+    size_t write(const char *buffer, size_t size) { return write((const uint8_t *)buffer, size); }
+
+    size_t print(const __FlashStringHelper *s) { return write(reinterpret_cast<const char *>(s)); }
+    size_t print(const char *s) { return write(s); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int n) { return print((long)n); }
+    size_t print(unsigned int n) { return print((unsigned long)n); }
+    size_t print(long n) { return printf("%ld", n); }
+    size_t print(unsigned long n) { return printf("%lu", n); }
+    size_t print(long long n) { return printf("%lld", n); }
+    size_t print(unsigned long long n) { return printf("%llu", n); }
+    size_t print(double n, int digits = 2)
+    {
+        if (isnan(n))
+            return print("nan");
+        if (isinf(n))
+            return print("inf");
+        return printf("%.*f", digits, n);
+    }
+    size_t println() { return print("\r\n"); }
+    template <typename T>
+    size_t println(T value) { return print(value) + println(); }
+
+    // Comme le core : tampon de 64 octets sur la pile, allocation au-delà
+    size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)))
+    {
+        char local[64];
+        va_list arg;
+        va_start(arg, format);
+        const int len = vsnprintf(local, sizeof(local), format, arg);
+        va_end(arg);
+        if (len < 0)
+            return 0;
+        if ((size_t)len < sizeof(local))
+            return write((const uint8_t *)local, len);
+        char *buffer = (char *)malloc(len + 1);
+        va_start(arg, format);
+        vsnprintf(buffer, len + 1, format, arg);
+        va_end(arg);
+        const size_t n = write((const uint8_t *)buffer, len);
+        free(buffer);
+        return n;
+    }
+};
+
+// Sortie série ignorée (les messages [Tag] des bibliothèques)
+class NativeSerial : public Print
+{
+public:
+    void begin(unsigned long) {}
+    size_t write(uint8_t) override { return 1; }
+    size_t write(const uint8_t *, size_t size) override { return size; }
+    using Print::write;
+    explicit operator bool() const { return true; }
+};
+static NativeSerial Serial;
+
+#endif // NATIVE_ARDUINO_H
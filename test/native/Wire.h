@@ -0,0 +1,141 @@
+/*
+ * Wire.h (tests sur PC)
+ * Bus I2C simulé, avec un SSD1306 au bout : le trafic est décodé comme le ferait le contrôleur
+ * - Octet de contrôle 0x00 : commandes (PAGEADDR, COLUMNADDR, MEMORYMODE... avec leurs arguments)
+ * - Octet de contrôle 0x40 : données écrites dans la GRAM, adressage horizontal dans la fenêtre
+ *   (colonne suivante, puis page suivante, puis retour au début de la fenêtre)
+ * La fenêtre et la position d'écriture sont conservées d'une transaction à l'autre
+ */
+
+#ifndef NATIVE_WIRE_H
+#define NATIVE_WIRE_H
+
+#include <Arduino.h>
+
+class TwoWire
+{
+public:
+    static const uint8_t COLUMNS = 128;
+    static const uint8_t PAGES = 8;
+
+    uint32_t clock = 100000;
+    uint32_t transactions = 0;
+    uint32_t bytesWritten = 0; // Octet de contrôle compris
+    uint32_t dataBytes = 0;    // Octets écrits dans la GRAM
+    uint8_t gram[PAGES * COLUMNS] = {};
+
+    void begin() {}
+    void setClock(uint32_t hz) { clock = hz; }
+    void beginTransmission(uint8_t) { position = 0; }
+    size_t write(uint8_t value)
+    {
+        bytesWritten++;
+        if (position++ == 0)
+            data = (value & 0x40) != 0;
+        else if (data)
+            writeData(value);
+        else
+            writeCommand(value);
+        return 1;
+    }
+    size_t write(const uint8_t *buffer, size_t length)
+    {
+        for (size_t i = 0; i < length; i++)
+            write(buffer[i]);
+        return length;
+    }
+    uint8_t endTransmission(bool = true)
+    {
+        transactions++;
+        return 0;
+    }
+
+    // Remise à zéro de la GRAM et des compteurs (entre deux tests)
+    void reset()
+    {
+        memset(gram, 0, sizeof(gram));
+        transactions = bytesWritten = dataBytes = 0;
+        command = argsLeft = argIndex = 0;
+        pageStart = columnStart = column = page = 0;
+        pageEnd = PAGES - 1;
+        columnEnd = COLUMNS - 1;
+    }
+
+private:
+    uint32_t position = 0; // Octet dans la transaction en cours
+    bool data = false;
+    uint8_t command = 0;   // Commande dont on attend les arguments
+    uint8_t argsLeft = 0;
+    uint8_t argIndex = 0;
+    uint8_t args[2] = {};
+    uint8_t pageStart = 0, pageEnd = PAGES - 1;
+    uint8_t columnStart = 0, columnEnd = COLUMNS - 1;
+    uint8_t page = 0, column = 0;
+
+    // Nombre d'arguments des commandes SSD1306 à plusieurs octets
+    static uint8_t argumentCount(uint8_t c)
+    {
+        switch (c)
+        {
+        case 0x21: // COLUMNADDR
+        case 0x22: // PAGEADDR
+            return 2;
+        case 0x20: // MEMORYMODE
+        case 0x81: // SETCONTRAST
+        case 0x8D: // CHARGEPUMP
+        case 0xA8: // SETMULTIPLEX
+        case 0xD3: // SETDISPLAYOFFSET
+        case 0xD5: // SETDISPLAYCLOCKDIV
+        case 0xD9: // SETPRECHARGE
+        case 0xDA: // SETCOMPINS
+        case 0xDB: // SETVCOMDETECT
+            return 1;
+        default:
+            return 0;
+        }
+    }
+
+    void writeCommand(uint8_t value)
+    {
+        if (argsLeft == 0)
+        {
+            command = value;
+            argsLeft = argumentCount(value);
+            argIndex = 0;
+            return;
+        }
+        args[argIndex++ & 1] = value;
+        if (--argsLeft > 0)
+            return;
+
+        if (command == 0x21)
+        {
+            columnStart = args[0] & 0x7F;
+            columnEnd = args[1] & 0x7F;
+            column = columnStart;
+        }
+        else if (command == 0x22)
+        {
+            pageStart = args[0] & 0x07;
+            pageEnd = args[1] & 0x07;
+            page = pageStart;
+        }
+    }
+
+    void writeData(uint8_t value)
+    {
+        gram[page * COLUMNS + column] = value;
+        dataBytes++;
+        if (column != columnEnd)
+        {
+            column = (column + 1) & 0x7F;
+            return;
+        }
+        column = columnStart;
+        page = (page == pageEnd) ? pageStart : (page + 1) & 0x07;
+    }
+};
+
+inline TwoWire Wire; // Une seule instance pour la bibliothèque et le test
+
+#endif // NATIVE_WIRE_H
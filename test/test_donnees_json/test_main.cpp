@@ -0,0 +1,456 @@
+/*
+ * Tests sur PC de la sérialisation de /api/data et /api/history (pio test -e native)
+ * - Le corps produit par ecrireDonneesJSON() est du JSON valide
+ * - Mêmes clés et mêmes valeurs que l'ancienne sérialisation ArduinoJson
+ *   ("history" est passé à /api/history, "hSeq" est la seule clé ajoutée)
+ * - ecrireHistoriqueJSON() : 30 points (historique plein), points choisis, historique vide
+ * - Durée et pic de tas des deux sérialisations, avec un historique plein de 30 points
+ *   (indicatifs : mesurés sur le PC, pas sur l'ESP)
+ */
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <unity.h>
+#include <cstddef>
+#include <new>
+#include <string>
+#include "DonneesJSON.h"
+
+static const int POINTS_HISTORIQUE = 30; // MAX_HISTORY_POINTS (config.h)
+
+// -------------------- Mesure du tas --------------------
+// operator new (std::string, conteneurs) et allocateur des JsonDocument comptés ensemble.
+// Chaque bloc porte sa taille en en-tête pour que la libération la décompte
+struct alignas(std::max_align_t) EnTete
+{
+    size_t taille;
+};
+static size_t tasActuel = 0;
+static size_t tasPic = 0;
+
+static void *allouer(size_t taille)
+{
+    EnTete *bloc = (EnTete *)malloc(sizeof(EnTete) + taille);
+    if (bloc == nullptr)
+        return nullptr;
+    bloc->taille = taille;
+    tasActuel += taille;
+    if (tasActuel > tasPic)
+        tasPic = tasActuel;
+    return bloc + 1;
+}
+
+static void liberer(void *p)
+{
+    if (p == nullptr)
+        return;
+    EnTete *bloc = (EnTete *)p - 1;
+    tasActuel -= bloc->taille;
+    free(bloc);
+}
+
+static void *reallouer(void *p, size_t taille)
+{
+    if (p == nullptr)
+        return allouer(taille);
+    EnTete *ancien = (EnTete *)p - 1;
+    const size_t ancienneTaille = ancien->taille;
+    EnTete *bloc = (EnTete *)realloc(ancien, sizeof(EnTete) + taille);
+    if (bloc == nullptr)
+        return nullptr;
+    bloc->taille = taille;
+    tasActuel = tasActuel - ancienneTaille + taille;
+    if (tasActuel > tasPic)
+        tasPic = tasActuel;
+    return bloc + 1;
+}
+
+void *operator new(size_t taille)
+{
+    void *p = allouer(taille);
+    if (p == nullptr)
+        throw std::bad_alloc();
+    return p;
+}
+void operator delete(void *p) noexcept { liberer(p); }
+void operator delete(void *p, size_t) noexcept { liberer(p); }
+
+class CompteurAllocator : public ArduinoJson::Allocator
+{
+public:
+    void *allocate(size_t taille) override { return allouer(taille); }
+    void deallocate(void *p) override { liberer(p); }
+    void *reallocate(void *p, size_t taille) override { return reallouer(p, taille); }
+};
+static CompteurAllocator compteurAllocator;
+
+// Pic de tas pendant fonction(), au-delà du tas déjà utilisé
+template <typename Fonction>
+static size_t picDeTas(Fonction fonction)
+{
+    const size_t depart = tasActuel;
+    tasPic = depart;
+    fonction();
+    return tasPic - depart;
+}
+
+// Print vers un tampon fixe, comme BufferPrint (lib/WiFiManager)
+class TamponPrint : public Print
+{
+public:
+    char texte[1024]; // Corps de /api/history avec 30 points
+    size_t longueur = 0;
+    bool deborde = false;
+
+    size_t write(uint8_t c) override
+    {
+        if (longueur + 1 >= sizeof(texte))
+        {
+            deborde = true;
+            return 0;
+        }
+        texte[longueur++] = c;
+        texte[longueur] = '\0';
+        return 1;
+    }
+    using Print::write;
+};
+
+// Sérialisation d'avant le passage à Print (JsonDocument), sans l'historique
+static size_t ancienneSerialisation(const DonneesDistributeur &d, char *buffer, size_t taille)
+{
+    JsonDocument doc;
+    doc["version"] = d.version;
+    doc["nbCroquettes"] = d.nbCroquettes;
+    doc["nbCroquinettes"] = d.nbCroquinettes;
+    doc["tCroquettes"] = d.tCroquettes;
+    doc["tCroquinettes"] = d.tCroquinettes;
+    doc["tNextCroquettes"] = d.tCroquettes + d.delaySec + d.absences * d.snoozeSec;
+    doc["delaySec"] = d.delaySec;
+    doc["mass"] = d.mass;
+    doc["ration"] = d.ration;
+    doc["autoMiam"] = d.autoMiam;
+
+    char timeBuf[6];
+    sprintf(timeBuf, "%02d:%02d", d.heureDebut, d.minuteDebut);
+    doc["timeStart"] = timeBuf;
+    sprintf(timeBuf, "%02d:%02d", d.heureFin, d.minuteFin);
+    doc["timeEnd"] = timeBuf;
+
+    return serializeJson(doc, buffer, taille);
+}
+
+static DonneesDistributeur etatDemarrage()
+{
+    DonneesDistributeur d = {};
+    d.version = 1;
+    d.delaySec = 4 * 3600;
+    d.snoozeSec = 15 * 60;
+    d.ration = 60;
+    d.autoMiam = true;
+    d.heureDebut = 7;
+    d.minuteDebut = 30;
+    d.heureFin = 23;
+    d.minuteFin = 15;
+    return d;
+}
+
+static DonneesDistributeur etatJournee()
+{
+    DonneesDistributeur d = etatDemarrage();
+    d.version = 4821;
+    d.nbCroquettes = 5;
+    d.nbCroquinettes = 12;
+    d.tCroquettes = 61234;
+    d.tCroquinettes = 70001;
+    d.absences = 3;
+    d.mass = 47;
+    d.autoMiam = false;
+    d.heureDebut = 0;
+    d.minuteDebut = 5;
+    d.hSeq = 212;
+    return d;
+}
+
+// Plus grandes valeurs de chaque champ : le corps doit tenir dans TAILLE_CACHE_DONNEES (512)
+static DonneesDistributeur etatMaximal()
+{
+    DonneesDistributeur d = etatJournee();
+    d.version = 4294967295UL;
+    d.nbCroquettes = 65535;
+    d.nbCroquinettes = 65535;
+    d.tCroquettes = 86399;
+    d.tCroquinettes = 86399;
+    d.delaySec = 86400;
+    d.absences = 96;
+    d.snoozeSec = 86400;
+    d.mass = -32768;
+    d.ration = 32767;
+    d.heureFin = 23;
+    d.minuteFin = 59;
+    d.hSeq = 4294967295UL;
+    return d;
+}
+
+// Historique plein : une distribution toutes les ~48 min, masse croissante
+static void historiquePlein(FeedingTime *points)
+{
+    for (int i = 0; i < POINTS_HISTORIQUE; i++)
+    {
+        points[i].timestamp = 1800 + i * 2871UL;
+        points[i].cumulativeMass = i * 7 - (i == 0 ? 32768 : 0); // Premier point : plus petite masse
+    }
+    points[POINTS_HISTORIQUE - 1].timestamp = 86399;
+    points[POINTS_HISTORIQUE - 1].cumulativeMass = 32767;
+}
+
+// Ancien /api/data : état et historique [{t,m},...] dans un seul JsonDocument, corps dans une chaîne
+static size_t ancienneSerialisationAvecHistorique(const DonneesDistributeur &d, const FeedingTime *points,
+                                                  std::string &sortie)
+{
+    JsonDocument doc(&compteurAllocator);
+    doc["nbCroquettes"] = d.nbCroquettes;
+    doc["nbCroquinettes"] = d.nbCroquinettes;
+    doc["tCroquettes"] = d.tCroquettes;
+    doc["tCroquinettes"] = d.tCroquinettes;
+    doc["delaySec"] = d.delaySec;
+    doc["mass"] = d.mass;
+    doc["ration"] = d.ration;
+    doc["autoMiam"] = d.autoMiam;
+    char timeBuf[6];
+    sprintf(timeBuf, "%02d:%02d", d.heureDebut, d.minuteDebut);
+    doc["timeStart"] = timeBuf;
+    sprintf(timeBuf, "%02d:%02d", d.heureFin, d.minuteFin);
+    doc["timeEnd"] = timeBuf;
+
+    JsonArray hist = doc["history"].to<JsonArray>();
+    for (int i = 0; i < POINTS_HISTORIQUE; i++)
+    {
+        JsonObject point = hist.add<JsonObject>();
+        point["t"] = points[i].timestamp;
+        point["m"] = points[i].cumulativeMass;
+    }
+    return serializeJson(doc, sortie);
+}
+
+// Nouveau : /api/data puis /api/history, chacun dans un tampon fixe (ResponseWriter sur l'ESP)
+static size_t nouvelleSerialisationAvecHistorique(const DonneesDistributeur &d, const FeedingTime *points)
+{
+    TamponPrint donnees;
+    ecrireDonneesJSON(donnees, d);
+    TamponPrint historique;
+    historique.printf("{\"next\":%lu,\"reset\":true,\"sampled\":false,\"points\":", d.hSeq);
+    ecrireHistoriqueJSON(historique, points, 0, POINTS_HISTORIQUE);
+    historique.print('}');
+    return donnees.longueur + historique.longueur;
+}
+
+// [[t,m],...] relu point par point
+static void verifierPoints(const char *texte, size_t longueur, const FeedingTime *points,
+                           const uint8_t *indices, int nombre)
+{
+    JsonDocument doc;
+    DeserializationError erreur = deserializeJson(doc, texte, longueur);
+    TEST_ASSERT_EQUAL_STRING_MESSAGE("Ok", erreur.c_str(), texte);
+    TEST_ASSERT_TRUE(doc.is<JsonArrayConst>());
+    JsonArrayConst lus = doc.as<JsonArrayConst>();
+    TEST_ASSERT_EQUAL_UINT32(nombre, lus.size());
+    for (int i = 0; i < nombre; i++)
+    {
+        const FeedingTime &attendu = points[indices != nullptr ? indices[i] : i];
+        TEST_ASSERT_EQUAL_UINT32(attendu.timestamp, lus[i][0].as<unsigned long>());
+        TEST_ASSERT_EQUAL_INT(attendu.cumulativeMass, lus[i][1].as<int>());
+    }
+}
+
+static void verifierCompatible(const DonneesDistributeur &d)
+{
+    TamponPrint nouveau;
+    ecrireDonneesJSON(nouveau, d);
+    TEST_ASSERT_FALSE(nouveau.deborde);
+    TEST_ASSERT_LESS_THAN(512, nouveau.longueur); // TAILLE_CACHE_DONNEES
+
+    char ancien[512];
+    ancienneSerialisation(d, ancien, sizeof(ancien));
+
+    JsonDocument docNouveau;
+    JsonDocument docAncien;
+    DeserializationError erreur = deserializeJson(docNouveau, nouveau.texte, nouveau.longueur);
+    TEST_ASSERT_EQUAL_STRING_MESSAGE("Ok", erreur.c_str(), nouveau.texte);
+    TEST_ASSERT_TRUE(docNouveau.is<JsonObject>());
+    erreur = deserializeJson(docAncien, ancien);
+    TEST_ASSERT_EQUAL_STRING("Ok", erreur.c_str());
+
+    // Chaque clé de l'ancien corps, avec la même valeur (comparée sous forme JSON)
+    for (JsonPairConst champ : docAncien.as<JsonObjectConst>())
+    {
+        JsonVariantConst valeur = docNouveau[champ.key()];
+        TEST_ASSERT_FALSE_MESSAGE(valeur.isNull(), champ.key().c_str());
+        char attendu[32];
+        char obtenu[32];
+        serializeJson(champ.value(), attendu, sizeof(attendu));
+        serializeJson(valeur, obtenu, sizeof(obtenu));
+        TEST_ASSERT_EQUAL_STRING_MESSAGE(attendu, obtenu, champ.key().c_str());
+    }
+
+    // Aucune autre clé que hSeq
+    for (JsonPairConst champ : docNouveau.as<JsonObjectConst>())
+    {
+        if (strcmp(champ.key().c_str(), "hSeq") != 0)
+        {
+            TEST_ASSERT_FALSE_MESSAGE(docAncien[champ.key()].isNull(), champ.key().c_str());
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(d.hSeq, docNouveau["hSeq"].as<unsigned long>());
+}
+
+void test_etat_demarrage()
+{
+    verifierCompatible(etatDemarrage());
+}
+
+void test_etat_journee()
+{
+    verifierCompatible(etatJournee());
+}
+
+void test_etat_maximal()
+{
+    verifierCompatible(etatMaximal());
+}
+
+void test_plage_horaire_sur_deux_chiffres()
+{
+    TamponPrint out;
+    ecrireDonneesJSON(out, etatJournee());
+    TEST_ASSERT_NOT_NULL(strstr(out.texte, "\"timeStart\":\"00:05\""));
+    TEST_ASSERT_NOT_NULL(strstr(out.texte, "\"timeEnd\":\"23:15\""));
+    TEST_ASSERT_NOT_NULL(strstr(out.texte, "\"autoMiam\":false"));
+}
+
+void test_historique_plein()
+{
+    FeedingTime points[POINTS_HISTORIQUE];
+    historiquePlein(points);
+    TamponPrint out;
+    ecrireHistoriqueJSON(out, points, 0, POINTS_HISTORIQUE);
+    TEST_ASSERT_FALSE(out.deborde);
+    verifierPoints(out.texte, out.longueur, points, nullptr, POINTS_HISTORIQUE);
+}
+
+void test_historique_points_choisis()
+{
+    FeedingTime points[POINTS_HISTORIQUE];
+    historiquePlein(points);
+    const uint8_t indices[] = {0, 4, 11, 12, 29};
+    TamponPrint out;
+    ecrireHistoriqueJSON(out, points, indices, sizeof(indices));
+    verifierPoints(out.texte, out.longueur, points, indices, sizeof(indices));
+
+    // Fin de l'historique seulement (?since=)
+    TamponPrint suite;
+    ecrireHistoriqueJSON(suite, points, 27, POINTS_HISTORIQUE);
+    verifierPoints(suite.texte, suite.longueur, points + 27, nullptr, 3);
+}
+
+void test_historique_vide()
+{
+    FeedingTime points[1] = {};
+    TamponPrint out;
+    ecrireHistoriqueJSON(out, points, 0, 0);
+    TEST_ASSERT_EQUAL_STRING("[]", out.texte);
+    TamponPrint choisis;
+    ecrireHistoriqueJSON(choisis, points, nullptr, 0);
+    TEST_ASSERT_EQUAL_STRING("[]", choisis.texte);
+}
+
+void test_duree_serialisation()
+{
+    const int REPETITIONS = 20000;
+    const DonneesDistributeur d = etatJournee();
+    size_t longueurNouveau = 0;
+    size_t longueurAncien = 0;
+
+    unsigned long debut = micros();
+    for (int i = 0; i < REPETITIONS; i++)
+    {
+        TamponPrint out;
+        ecrireDonneesJSON(out, d);
+        longueurNouveau += out.longueur;
+    }
+    const unsigned long dureeNouveau = micros() - debut;
+
+    debut = micros();
+    for (int i = 0; i < REPETITIONS; i++)
+    {
+        char ancien[512];
+        longueurAncien += ancienneSerialisation(d, ancien, sizeof(ancien));
+    }
+    const unsigned long dureeAncien = micros() - debut;
+
+    char message[128];
+    snprintf(message, sizeof(message), "Print : %.3f us pour %zu octets, JsonDocument : %.3f us pour %zu octets",
+             (double)dureeNouveau / REPETITIONS, longueurNouveau / REPETITIONS,
+             (double)dureeAncien / REPETITIONS, longueurAncien / REPETITIONS);
+    TEST_MESSAGE(message);
+}
+
+// Historique plein : ancien /api/data (état + historique) contre /api/data + /api/history
+void test_duree_et_tas_historique_plein()
+{
+    const int REPETITIONS = 5000;
+    const DonneesDistributeur d = etatJournee();
+    FeedingTime points[POINTS_HISTORIQUE];
+    historiquePlein(points);
+
+    size_t octetsNouveau = 0;
+    const size_t tasNouveau = picDeTas([&]()
+                                       { octetsNouveau = nouvelleSerialisationAvecHistorique(d, points); });
+    size_t octetsAncien = 0;
+    const size_t tasAncien = picDeTas([&]()
+                                      {
+                                          std::string sortie;
+                                          octetsAncien = ancienneSerialisationAvecHistorique(d, points, sortie);
+                                      });
+    TEST_ASSERT_EQUAL_UINT32(0, tasNouveau); // Tampons sur la pile, printf sous 64 octets
+    TEST_ASSERT_GREATER_THAN(0, tasAncien);
+
+    unsigned long debut = micros();
+    for (int i = 0; i < REPETITIONS; i++)
+        nouvelleSerialisationAvecHistorique(d, points);
+    const unsigned long dureeNouveau = micros() - debut;
+
+    debut = micros();
+    for (int i = 0; i < REPETITIONS; i++)
+    {
+        std::string sortie;
+        ancienneSerialisationAvecHistorique(d, points, sortie);
+    }
+    const unsigned long dureeAncien = micros() - debut;
+
+    char message[160];
+    snprintf(message, sizeof(message), "30 points, Print : %.2f us, %zu octets, tas %zu octets",
+             (double)dureeNouveau / REPETITIONS, octetsNouveau, tasNouveau);
+    TEST_MESSAGE(message);
+    snprintf(message, sizeof(message), "30 points, JsonDocument : %.2f us, %zu octets, pic de tas %zu octets",
+             (double)dureeAncien / REPETITIONS, octetsAncien, tasAncien);
+    TEST_MESSAGE(message);
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_etat_demarrage);
+    RUN_TEST(test_etat_journee);
+    RUN_TEST(test_etat_maximal);
+    RUN_TEST(test_plage_horaire_sur_deux_chiffres);
+    RUN_TEST(test_historique_plein);
+    RUN_TEST(test_historique_points_choisis);
+    RUN_TEST(test_historique_vide);
+    RUN_TEST(test_duree_serialisation);
+    RUN_TEST(test_duree_et_tas_historique_plein);
+    return UNITY_END();
+}
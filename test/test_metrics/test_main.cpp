@@ -0,0 +1,492 @@
+/*
+ * Tests sur PC de lib/Metrics (pio test -e native)
+ * - Sortie de PrometheusWriter relue par un parseur du format texte 0.0.4
+ *   (noms, échappement des labels et de HELP, _sum / _count des résumés)
+ * - LatencyHistogram::percentileUs : histogramme vide, seau 0, dernier seau, monotonie
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include <Metrics.h>
+#include <string>
+#include <vector>
+#include <map>
+
+// Print vers une std::string
+class TextePrint : public Print
+{
+public:
+    std::string texte;
+    size_t write(uint8_t c) override
+    {
+        texte += (char)c;
+        return 1;
+    }
+    using Print::write;
+};
+
+// -------------------- Parseur du format texte Prometheus 0.0.4 --------------------
+struct Echantillon
+{
+    std::string nom;
+    std::map<std::string, std::string> labels;
+    double valeur;
+};
+
+struct Famille
+{
+    std::string nom;
+    std::string type;
+    std::string aide;
+    std::vector<Echantillon> echantillons;
+};
+
+struct Exposition
+{
+    std::vector<Famille> familles;
+    std::string erreur; // Vide si le texte est valide
+
+    const Famille *famille(const std::string &nom) const
+    {
+        for (const Famille &f : familles)
+            if (f.nom == nom)
+                return &f;
+        return nullptr;
+    }
+};
+
+static bool debutNom(char c, bool metrique)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || (metrique && c == ':');
+}
+
+static bool suiteNom(char c, bool metrique)
+{
+    return debutNom(c, metrique) || (c >= '0' && c <= '9');
+}
+
+static bool lireNom(const std::string &ligne, size_t &i, bool metrique, std::string &nom)
+{
+    if (i >= ligne.size() || !debutNom(ligne[i], metrique))
+        return false;
+    const size_t debut = i;
+    while (i < ligne.size() && suiteNom(ligne[i], metrique))
+        i++;
+    nom = ligne.substr(debut, i - debut);
+    return true;
+}
+
+// Échappements admis : \\ et \n, plus \" si guillemets (valeur de label)
+static bool desechapper(const std::string &ligne, size_t &i, bool guillemets, std::string &sortie)
+{
+    sortie.clear();
+    while (i < ligne.size())
+    {
+        const char c = ligne[i++];
+        if (guillemets && c == '"')
+            return true;
+        if (c != '\\')
+        {
+            sortie += c;
+            continue;
+        }
+        if (i >= ligne.size())
+            return false;
+        const char e = ligne[i++];
+        if (e == '\\')
+            sortie += '\\';
+        else if (e == 'n')
+            sortie += '\n';
+        else if (e == '"' && guillemets)
+            sortie += '"';
+        else
+            return false;
+    }
+    return !guillemets; // Une valeur de label doit se terminer par "
+}
+
+static bool lireValeur(const std::string &texte, double &valeur)
+{
+    if (texte == "NaN")
+        valeur = NAN;
+    else if (texte == "+Inf")
+        valeur = INFINITY;
+    else if (texte == "-Inf")
+        valeur = -INFINITY;
+    else
+    {
+        char *fin = nullptr;
+        valeur = strtod(texte.c_str(), &fin);
+        if (texte.empty() || *fin != '\0')
+            return false;
+    }
+    return true;
+}
+
+// Un échantillon appartient à la famille courante (suffixes des résumés et histogrammes)
+static bool appartient(const Famille &f, const std::string &nom)
+{
+    if (nom == f.nom)
+        return true;
+    if (f.type == "summary" || f.type == "histogram")
+    {
+        if (nom == f.nom + "_sum" || nom == f.nom + "_count")
+            return true;
+    }
+    return f.type == "histogram" && nom == f.nom + "_bucket";
+}
+
+static Exposition analyser(const std::string &texte)
+{
+    Exposition exposition;
+    if (!texte.empty() && texte.back() != '\n')
+    {
+        exposition.erreur = "Dernière ligne sans \\n";
+        return exposition;
+    }
+
+    size_t position = 0;
+    while (position < texte.size())
+    {
+        const size_t finLigne = texte.find('\n', position);
+        const std::string ligne = texte.substr(position, finLigne - position);
+        position = finLigne + 1;
+        if (ligne.empty())
+            continue;
+
+        if (ligne[0] == '#')
+        {
+            size_t i = 1;
+            const bool aide = ligne.compare(0, 7, "# HELP ") == 0;
+            const bool type = ligne.compare(0, 7, "# TYPE ") == 0;
+            if (!aide && !type)
+                continue; // Commentaire libre
+            i = 7;
+            std::string nom;
+            if (!lireNom(ligne, i, true, nom) || i >= ligne.size() || ligne[i] != ' ')
+            {
+                exposition.erreur = "En-tête invalide : " + ligne;
+                return exposition;
+            }
+            i++;
+            if (exposition.familles.empty() || exposition.familles.back().nom != nom)
+            {
+                if (exposition.famille(nom) != nullptr)
+                {
+                    exposition.erreur = "Famille répétée : " + nom;
+                    return exposition;
+                }
+                exposition.familles.push_back(Famille{nom, "untyped", "", {}});
+            }
+            Famille &f = exposition.familles.back();
+            if (!f.echantillons.empty())
+            {
+                exposition.erreur = "En-tête après les échantillons : " + ligne;
+                return exposition;
+            }
+            if (aide && !desechapper(ligne, i, false, f.aide))
+            {
+                exposition.erreur = "Échappement invalide : " + ligne;
+                return exposition;
+            }
+            if (type)
+            {
+                f.type = ligne.substr(i);
+                if (f.type != "counter" && f.type != "gauge" && f.type != "summary" &&
+                    f.type != "histogram" && f.type != "untyped")
+                {
+                    exposition.erreur = "Type inconnu : " + ligne;
+                    return exposition;
+                }
+            }
+            continue;
+        }
+
+        Echantillon e;
+        size_t i = 0;
+        if (!lireNom(ligne, i, true, e.nom))
+        {
+            exposition.erreur = "Nom invalide : " + ligne;
+            return exposition;
+        }
+        if (i < ligne.size() && ligne[i] == '{')
+        {
+            i++;
+            while (i < ligne.size() && ligne[i] != '}')
+            {
+                std::string label;
+                std::string valeur;
+                if (!lireNom(ligne, i, false, label) || ligne.compare(i, 2, "=\"") != 0)
+                {
+                    exposition.erreur = "Label invalide : " + ligne;
+                    return exposition;
+                }
+                i += 2;
+                if (!desechapper(ligne, i, true, valeur) || e.labels.count(label) != 0)
+                {
+                    exposition.erreur = "Valeur de label invalide : " + ligne;
+                    return exposition;
+                }
+                e.labels[label] = valeur;
+                if (i < ligne.size() && ligne[i] == ',')
+                    i++;
+            }
+            if (i >= ligne.size())
+            {
+                exposition.erreur = "Labels non fermés : " + ligne;
+                return exposition;
+            }
+            i++;
+        }
+        if (i >= ligne.size() || ligne[i] != ' ')
+        {
+            exposition.erreur = "Espace attendu avant la valeur : " + ligne;
+            return exposition;
+        }
+        const size_t finValeur = ligne.find(' ', i + 1);
+        if (!lireValeur(ligne.substr(i + 1, finValeur == std::string::npos ? std::string::npos : finValeur - i - 1), e.valeur))
+        {
+            exposition.erreur = "Valeur invalide : " + ligne;
+            return exposition;
+        }
+
+        if (exposition.familles.empty() || !appartient(exposition.familles.back(), e.nom))
+        {
+            exposition.erreur = "Échantillon hors de sa famille : " + ligne;
+            return exposition;
+        }
+        for (const Echantillon &autre : exposition.familles.back().echantillons)
+        {
+            if (autre.nom == e.nom && autre.labels == e.labels)
+            {
+                exposition.erreur = "Série en double : " + ligne;
+                return exposition;
+            }
+        }
+        exposition.familles.back().echantillons.push_back(e);
+    }
+    return exposition;
+}
+
+static const Echantillon *trouver(const Famille &f, const std::string &nom, const char *quantile = nullptr)
+{
+    for (const Echantillon &e : f.echantillons)
+    {
+        if (e.nom != nom)
+            continue;
+        auto q = e.labels.find("quantile");
+        if (quantile == nullptr ? q == e.labels.end() : (q != e.labels.end() && q->second == quantile))
+            return &e;
+    }
+    return nullptr;
+}
+
+static Exposition analyserSansErreur(const std::string &texte)
+{
+    Exposition exposition = analyser(texte);
+    TEST_ASSERT_EQUAL_STRING_MESSAGE("", exposition.erreur.c_str(), texte.c_str());
+    return exposition;
+}
+
+// -------------------- PrometheusWriter --------------------
+void test_parseur_refuse_texte_invalide()
+{
+    TEST_ASSERT_FALSE(analyser("a 1").erreur.empty());                      // Pas de \n final
+    TEST_ASSERT_FALSE(analyser("a{x=\"1} 1\n").erreur.empty());             // Label non fermé
+    TEST_ASSERT_FALSE(analyser("a{x=\"\\t\"} 1\n").erreur.empty());         // Échappement inconnu
+    TEST_ASSERT_FALSE(analyser("# TYPE a counter\nb 1\n").erreur.empty());  // Hors famille
+    TEST_ASSERT_FALSE(analyser("# TYPE a counter\na 1\na 2\n").erreur.empty()); // Série en double
+    TEST_ASSERT_FALSE(analyser("# TYPE a counter\na one\n").erreur.empty());
+}
+
+void test_famille_et_valeurs()
+{
+    TextePrint out;
+    PrometheusWriter prom(out);
+    prom.counter("app_boots_total", "Démarrages", 7UL);
+    prom.gauge("app_temperature_celsius", "Température", 21.5f, 1);
+    prom.gauge("app_offset", "Décalage", -42L);
+    prom.family("app_big", "counter", "Compteur 64 bits");
+    prom.sample("app_big").value(18446744073709551615ULL);
+    prom.family("app_nan", "gauge", "Sans mesure");
+    prom.sample("app_nan").value(NAN);
+
+    const Exposition e = analyserSansErreur(out.texte);
+    TEST_ASSERT_EQUAL(5, e.familles.size());
+    TEST_ASSERT_EQUAL_STRING("counter", e.famille("app_boots_total")->type.c_str());
+    TEST_ASSERT_EQUAL_STRING("Démarrages", e.famille("app_boots_total")->aide.c_str());
+    TEST_ASSERT_EQUAL_DOUBLE(7, e.famille("app_boots_total")->echantillons[0].valeur);
+    TEST_ASSERT_EQUAL_DOUBLE(21.5, e.famille("app_temperature_celsius")->echantillons[0].valeur);
+    TEST_ASSERT_EQUAL_DOUBLE(-42, e.famille("app_offset")->echantillons[0].valeur);
+    TEST_ASSERT_NOT_NULL(strstr(out.texte.c_str(), "app_big 18446744073709551615\n"));
+    TEST_ASSERT_TRUE(isnan(e.famille("app_nan")->echantillons[0].valeur));
+    TEST_ASSERT_EQUAL(out.texte.size(), prom.getBytesWritten());
+}
+
+void test_echappement_des_labels()
+{
+    const char *valeur = "C:\\chemin \"cité\"\nligne 2";
+    TextePrint out;
+    PrometheusWriter prom(out);
+    prom.family("app_requests_total", "counter", "Aide \\ sur\ndeux lignes, \"entre guillemets\"");
+    prom.sample("app_requests_total").label("route", valeur).label("code", 200L).value(3UL);
+    prom.sample("app_requests_total").label("route", "/").label("code", -1L).value(1UL);
+
+    // Guillemet échappé dans un label, pas dans HELP
+    TEST_ASSERT_NOT_NULL(strstr(out.texte.c_str(), "route=\"C:\\\\chemin \\\"cité\\\"\\nligne 2\""));
+    TEST_ASSERT_NOT_NULL(strstr(out.texte.c_str(), "# HELP app_requests_total Aide \\\\ sur\\ndeux lignes, \"entre guillemets\"\n"));
+
+    const Exposition e = analyserSansErreur(out.texte);
+    const Famille *f = e.famille("app_requests_total");
+    TEST_ASSERT_NOT_NULL(f);
+    TEST_ASSERT_EQUAL_STRING("Aide \\ sur\ndeux lignes, \"entre guillemets\"", f->aide.c_str());
+    TEST_ASSERT_EQUAL(2, f->echantillons.size());
+    TEST_ASSERT_EQUAL_STRING(valeur, f->echantillons[0].labels.at("route").c_str());
+    TEST_ASSERT_EQUAL_STRING("200", f->echantillons[0].labels.at("code").c_str());
+    TEST_ASSERT_EQUAL_STRING("-1", f->echantillons[1].labels.at("code").c_str());
+    TEST_ASSERT_EQUAL_DOUBLE(3, f->echantillons[0].valeur);
+}
+
+void test_resume_sum_et_count()
+{
+    LatencyHistogram h;
+    const uint32_t durees[] = {0, 3, 150, 900, 1200, 25000, 1500000};
+    uint64_t somme = 0;
+    for (uint32_t d : durees)
+    {
+        h.record(d);
+        somme += d;
+    }
+
+    TextePrint out;
+    PrometheusWriter prom(out);
+    prom.summary("app_handler_seconds", "Durée des handlers", h);
+
+    const Exposition e = analyserSansErreur(out.texte);
+    const Famille *f = e.famille("app_handler_seconds");
+    TEST_ASSERT_NOT_NULL(f);
+    TEST_ASSERT_EQUAL_STRING("summary", f->type.c_str());
+    TEST_ASSERT_EQUAL(5, f->echantillons.size());
+
+    const Echantillon *sum = trouver(*f, "app_handler_seconds_sum");
+    const Echantillon *count = trouver(*f, "app_handler_seconds_count");
+    TEST_ASSERT_NOT_NULL(sum);
+    TEST_ASSERT_NOT_NULL(count);
+    TEST_ASSERT_DOUBLE_WITHIN(0.0005, somme / 1e6, sum->valeur); // 3 décimales
+    TEST_ASSERT_EQUAL_DOUBLE(7, count->valeur);
+
+    // Quantiles en secondes, croissants, jamais au-delà du maximum observé
+    double precedent = 0;
+    const char *quantiles[] = {"0.5", "0.9", "0.99"};
+    const float q[] = {0.5f, 0.9f, 0.99f};
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        const Echantillon *s = trouver(*f, "app_handler_seconds", quantiles[i]);
+        TEST_ASSERT_NOT_NULL(s);
+        TEST_ASSERT_DOUBLE_WITHIN(1e-6, h.percentileUs(q[i]) / 1e6, s->valeur);
+        TEST_ASSERT_TRUE(s->valeur >= precedent);
+        TEST_ASSERT_TRUE(s->valeur <= 1.5);
+        precedent = s->valeur;
+    }
+}
+
+void test_resume_vide()
+{
+    LatencyHistogram h;
+    TextePrint out;
+    PrometheusWriter prom(out);
+    prom.summary("app_idle_seconds", "Jamais appelé", h);
+
+    const Exposition e = analyserSansErreur(out.texte);
+    const Famille *f = e.famille("app_idle_seconds");
+    TEST_ASSERT_NOT_NULL(f);
+    for (const Echantillon &s : f->echantillons)
+    {
+        TEST_ASSERT_EQUAL_DOUBLE(0, s.valeur);
+    }
+    TEST_ASSERT_NOT_NULL(trouver(*f, "app_idle_seconds_sum"));
+    TEST_ASSERT_NOT_NULL(trouver(*f, "app_idle_seconds_count"));
+}
+
+// -------------------- LatencyHistogram --------------------
+void test_percentile_histogramme_vide()
+{
+    LatencyHistogram h;
+    TEST_ASSERT_EQUAL_UINT32(0, h.percentileUs(0.0f));
+    TEST_ASSERT_EQUAL_UINT32(0, h.percentileUs(0.5f));
+    TEST_ASSERT_EQUAL_UINT32(0, h.percentileUs(1.0f));
+    TEST_ASSERT_EQUAL_UINT32(0, h.getCount());
+}
+
+void test_percentile_seau_zero()
+{
+    LatencyHistogram h;
+    h.record(0);
+    TEST_ASSERT_EQUAL_UINT32(1, h.getBucket(0));
+    TEST_ASSERT_EQUAL_UINT32(0, h.percentileUs(0.5f));
+    TEST_ASSERT_EQUAL_UINT32(0, h.percentileUs(1.0f));
+}
+
+void test_percentile_borne_par_le_maximum()
+{
+    LatencyHistogram h;
+    h.record(5); // Seau [4, 8[
+    TEST_ASSERT_EQUAL_UINT32(1, h.getBucket(3));
+    TEST_ASSERT_EQUAL_UINT32(4, h.percentileUs(0.0f));
+    TEST_ASSERT_EQUAL_UINT32(5, h.percentileUs(1.0f));
+}
+
+void test_percentile_dernier_seau()
+{
+    const uint8_t dernier = LatencyHistogram::BUCKET_COUNT - 1;
+    const uint32_t basse = LatencyHistogram::getBucketUpperUs(dernier - 1);
+
+    LatencyHistogram h;
+    h.record(10000000);   // 10 s : au-delà du dernier seau nominal
+    h.record(0xFFFFFFFF); // Plus grande durée représentable
+    TEST_ASSERT_EQUAL_UINT32(2, h.getBucket(dernier));
+    TEST_ASSERT_EQUAL_UINT32(0xFFFFFFFF, h.getMaxUs());
+    TEST_ASSERT_EQUAL_UINT32(basse, h.percentileUs(0.0f));
+    TEST_ASSERT_EQUAL_UINT32(0xFFFFFFFF, h.percentileUs(1.0f));
+    const uint32_t p50 = h.percentileUs(0.5f);
+    TEST_ASSERT_TRUE(p50 >= basse);
+    TEST_ASSERT_TRUE(p50 <= h.getMaxUs());
+    TEST_ASSERT_EQUAL_UINT64(10000000ULL + 0xFFFFFFFFULL, h.getSumUs());
+}
+
+void test_percentile_monotone()
+{
+    LatencyHistogram h;
+    for (uint32_t d = 1; d < 200000; d = d * 3 / 2 + 1)
+    {
+        h.record(d);
+    }
+    uint32_t precedent = 0;
+    for (int i = 0; i <= 100; i++)
+    {
+        const uint32_t p = h.percentileUs(i / 100.0f);
+        TEST_ASSERT_TRUE(p >= precedent);
+        TEST_ASSERT_TRUE(p <= h.getMaxUs());
+        precedent = p;
+    }
+    TEST_ASSERT_EQUAL_UINT32(h.getMaxUs(), h.percentileUs(1.0f));
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_parseur_refuse_texte_invalide);
+    RUN_TEST(test_famille_et_valeurs);
+    RUN_TEST(test_echappement_des_labels);
+    RUN_TEST(test_resume_sum_et_count);
+    RUN_TEST(test_resume_vide);
+    RUN_TEST(test_percentile_histogramme_vide);
+    RUN_TEST(test_percentile_seau_zero);
+    RUN_TEST(test_percentile_borne_par_le_maximum);
+    RUN_TEST(test_percentile_dernier_seau);
+    RUN_TEST(test_percentile_monotone);
+    return UNITY_END();
+}
@@ -0,0 +1,247 @@
+/*
+ * Tests sur PC du rendu OLED jusqu'à l'écran (pio test -e native)
+ * Le trafic I2C est décodé par le SSD1306 simulé de test/native/Wire.h : on compare ce que
+ * l'écran affiche réellement, writePBM() et une image de référence (dossier golden)
+ * - Écrans réels : accueil et compteurs (EcransOLED.h, dessinés par main.cpp), message sur
+ *   plusieurs lignes (printMessage) et erreur à titre inversé (drawMessage, comme ScreenManager)
+ * - Image au format des pages (y non multiple de 8)
+ * - Envoi partiel : seules les colonnes modifiées passent sur le bus, compteurs et callback
+ *   décrivent l'envoi terminé, writePBM() attend la fin de l'envoi asynchrone
+ * Pour régénérer les images de référence après un changement voulu du rendu :
+ *   OLED_GOLDEN_UPDATE=1 pio test -e native -f test_oled
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include <string>
+#include <OLEDDisplay.h>
+#include "EcransOLED.h"
+#include "images.h"
+
+// Print vers une chaîne (image PBM complète)
+class ChainePrint : public Print
+{
+public:
+    std::string texte;
+
+    size_t write(uint8_t c) override
+    {
+        texte += (char)c;
+        return 1;
+    }
+    using Print::write;
+};
+
+// Image PBM de la GRAM du SSD1306 simulé, même format que writePBM()
+static std::string pbmEcran(uint8_t largeur, uint8_t hauteur)
+{
+    ChainePrint out;
+    out.printf("P4\n%u %u\n", largeur, hauteur);
+    for (uint8_t y = 0; y < hauteur; y++)
+    {
+        for (uint8_t i = 0; i < largeur / 8; i++)
+        {
+            uint8_t pixels = 0;
+            for (uint8_t x = 0; x < 8; x++)
+            {
+                if ((Wire.gram[(y / 8) * TwoWire::COLUMNS + i * 8 + x] & (1 << (y & 7))) == 0)
+                    pixels |= 0x80 >> x;
+            }
+            out.write(pixels);
+        }
+    }
+    return out.texte;
+}
+
+static std::string cheminReference(const char *nom)
+{
+    std::string dossier = __FILE__;
+    const size_t fin = dossier.find_last_of("/\\");
+    dossier = (fin == std::string::npos) ? "." : dossier.substr(0, fin);
+    return dossier + "/golden/" + nom;
+}
+
+// Compare l'image à la référence, ou la réécrit avec OLED_GOLDEN_UPDATE=1
+static void comparerReference(const char *nom, const std::string &image)
+{
+    const std::string chemin = cheminReference(nom);
+    if (getenv("OLED_GOLDEN_UPDATE") != nullptr)
+    {
+        FILE *fichier = fopen(chemin.c_str(), "wb");
+        TEST_ASSERT_NOT_NULL_MESSAGE(fichier, chemin.c_str());
+        fwrite(image.data(), 1, image.size(), fichier);
+        fclose(fichier);
+        TEST_MESSAGE((chemin + " réécrit").c_str());
+        return;
+    }
+
+    FILE *fichier = fopen(chemin.c_str(), "rb");
+    TEST_ASSERT_NOT_NULL_MESSAGE(fichier, chemin.c_str());
+    std::string reference;
+    char bloc[256];
+    size_t lus;
+    while ((lus = fread(bloc, 1, sizeof(bloc), fichier)) > 0)
+        reference.append(bloc, lus);
+    fclose(fichier);
+
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(reference.size(), image.size(), nom);
+    TEST_ASSERT_EQUAL_MEMORY_MESSAGE(reference.data(), image.data(), image.size(), nom);
+}
+
+// L'écran simulé, writePBM() et la référence donnent la même image
+static void verifierEcran(OLEDDisplay &oled, const char *nom)
+{
+    ChainePrint capture;
+    oled.writePBM(capture);
+    const std::string ecran = pbmEcran(128, 64);
+    TEST_ASSERT_EQUAL_UINT32(ecran.size(), capture.texte.size());
+    TEST_ASSERT_EQUAL_MEMORY_MESSAGE(ecran.data(), capture.texte.data(), ecran.size(), "écran / writePBM()");
+    comparerReference(nom, ecran);
+}
+
+// Milieu de journée : 3 distributions, ration à moitié mangée, WiFi moyen
+static DonneesEcrans donneesJournee()
+{
+    DonneesEcrans d = {};
+    d.jour = 7;
+    d.mois = 3;
+    d.annee = 2026;
+    d.heure = 12;
+    d.minute = 34;
+    d.signalWifi = 2;
+    d.prochainesCroquettes = 14 * 3600 + 5 * 60;
+    d.progression = 55;
+    d.nbCroquettes = 3;
+    d.nbCroquinettes = 12;
+    d.tCroquettes = 9 * 3600 + 45 * 60;
+    d.tCroquinettes = 11 * 3600 + 2 * 60;
+    return d;
+}
+
+// Comme ScreenManager::render() : écran effacé, dessiné, puis envoyé
+static void afficherAccueil(OLEDDisplay &oled, const DonneesEcrans &d)
+{
+    oled.clear();
+    dessinerEcranAccueil(oled, d);
+    oled.flush();
+}
+
+void test_ecran_accueil()
+{
+    Wire.reset();
+    OLEDDisplay oled(128, 64);
+    TEST_ASSERT_TRUE(oled.begin());
+    afficherAccueil(oled, donneesJournee());
+    verifierEcran(oled, "accueil.pbm");
+}
+
+void test_ecran_info()
+{
+    Wire.reset();
+    OLEDDisplay oled(128, 64);
+    TEST_ASSERT_TRUE(oled.begin());
+    oled.clear();
+    dessinerEcranInfo(oled, donneesJournee());
+    oled.flush();
+    verifierEcran(oled, "info.pbm");
+}
+
+// Message long : découpé aux espaces sur plusieurs lignes, accents compris
+void test_message()
+{
+    Wire.reset();
+    OLEDDisplay oled(128, 64);
+    TEST_ASSERT_TRUE(oled.begin());
+    oled.printMessage("No Grazou", "Distribution annulée. Gazou a suffisamment mangé aujourd'hui !", 3);
+    verifierEcran(oled, "message.pbm");
+}
+
+// Erreur : titre en noir sur bandeau blanc
+void test_erreur()
+{
+    Wire.reset();
+    OLEDDisplay oled(128, 64);
+    TEST_ASSERT_TRUE(oled.begin());
+    oled.drawMessage("Horloge", "Échec de synchronisation de l'heure RTC, vérifier la batterie ou le branchement.", true);
+    oled.flush();
+    verifierEcran(oled, "erreur.pbm");
+}
+
+void test_image()
+{
+    Wire.reset();
+    OLEDDisplay oled(128, 64);
+    TEST_ASSERT_TRUE(oled.begin());
+    oled.clear();
+    oled.printImage(IMAGE_CHAT_PAGES.bitmap(), 34, 13);
+    oled.flush();
+    verifierEcran(oled, "image.pbm");
+}
+
+void test_envoi_partiel()
+{
+    Wire.reset();
+    OLEDDisplay oled(128, 64);
+    TEST_ASSERT_TRUE(oled.begin());
+    DonneesEcrans d = donneesJournee();
+    afficherAccueil(oled, d);
+
+    uint16_t octetsCallback = 0;
+    std::string imageCallback;
+    oled.setFrameCallback([&](const uint8_t *, uint16_t octets)
+                          {
+                              octetsCallback = octets;
+                              imageCallback = pbmEcran(128, 64); // Écran au moment de l'appel
+                          });
+    oled.setAsyncFlush(true);
+    oled.setFlushBudget(0); // Une transaction par update()
+
+    // Même écran redessiné en entier, seule la dernière minute change
+    const uint32_t octetsAvant = Wire.dataBytes;
+    const uint32_t imagesAvant = oled.getFlushCount();
+    const std::string ecranAvant = pbmEcran(128, 64);
+    d.minute = 35;
+    afficherAccueil(oled, d);
+
+    // flush() asynchrone : rien n'est encore sur le bus, l'écran montre l'image précédente
+    TEST_ASSERT_TRUE(oled.isFlushing());
+    TEST_ASSERT_EQUAL_UINT32(octetsAvant, Wire.dataBytes);
+    TEST_ASSERT_TRUE(ecranAvant == pbmEcran(128, 64));
+
+    oled.update();
+    TEST_ASSERT_TRUE(oled.isFlushing()); // Encore des colonnes à envoyer
+    TEST_ASSERT_EQUAL_UINT32(imagesAvant, oled.getFlushCount());
+
+    // writePBM() termine l'envoi : l'image écrite est celle de l'écran
+    verifierEcran(oled, "envoi_partiel.pbm");
+    TEST_ASSERT_FALSE(oled.isFlushing());
+
+    const uint32_t octetsEnvoyes = Wire.dataBytes - octetsAvant;
+    TEST_ASSERT_EQUAL_UINT32(imagesAvant + 1, oled.getFlushCount());
+    TEST_ASSERT_EQUAL_UINT32(octetsEnvoyes, oled.getLastFlushBytes());
+    TEST_ASSERT_EQUAL_UINT32(octetsEnvoyes, octetsCallback);
+    TEST_ASSERT_TRUE(imageCallback == pbmEcran(128, 64));
+
+    // Un chiffre en taille 2 : 12 colonnes sur 3 pages au plus, loin d'un écran complet
+    TEST_ASSERT_GREATER_THAN_UINT32(0, octetsEnvoyes);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(3 * 12, octetsEnvoyes);
+
+    char message[64];
+    snprintf(message, sizeof(message), "%u octets de données pour 1024 octets d'écran", (unsigned)octetsEnvoyes);
+    TEST_MESSAGE(message);
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_ecran_accueil);
+    RUN_TEST(test_ecran_info);
+    RUN_TEST(test_message);
+    RUN_TEST(test_erreur);
+    RUN_TEST(test_image);
+    RUN_TEST(test_envoi_partiel);
+    return UNITY_END();
+}
@@ -0,0 +1,141 @@
+/*
+ * Tests sur PC des images au format des pages (pio test -e native)
+ * - toPageImage() (constexpr) donne la même image que drawBitmap() pixel par pixel
+ * - OLEDDisplay::printImage(PageBitmap) écrit dans le buffer exactement les mêmes octets que
+ *   l'ancien chemin printImage(bitmap, w, h) à chaque position, y non multiple de 8 compris,
+ *   sur fond vide ou déjà dessiné, en 128x64 et 128x32
+ * - Durée des deux chemins (indicative : mesurée sur le PC, pas sur l'ESP)
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+#include <OLEDDisplay.h>
+#include "images.h"
+
+// Image de test : largeur non multiple de 8, dernière page incomplète
+static const uint8_t PETITE_LARGEUR = 13;
+static const uint8_t PETITE_HAUTEUR = 11;
+constexpr unsigned char PETITE_IMAGE[] PROGMEM = {
+    0xFF, 0xF8, 0x80, 0x08, 0xA5, 0x28, 0x80, 0x08, 0x9F, 0xC8, 0x90, 0x48,
+    0x97, 0x48, 0x90, 0x48, 0x9F, 0xC8, 0x80, 0x08, 0xFF, 0xF8};
+constexpr PageImage<PETITE_LARGEUR, PETITE_HAUTEUR> PETITE_IMAGE_PAGES PROGMEM =
+    toPageImage<PETITE_LARGEUR, PETITE_HAUTEUR>(PETITE_IMAGE);
+
+static void fondDessine(OLEDDisplay &oled)
+{
+    // Motif irrégulier : vérifie que les deux chemins ajoutent les pixels (OU) sans effacer
+    uint8_t *buffer = oled.getDisplay()->getBuffer();
+    const size_t taille = oled.getDisplay()->width() * oled.getDisplay()->height() / 8;
+    for (size_t i = 0; i < taille; i++)
+        buffer[i] = (uint8_t)(i * 37 + (i >> 3)) & 0x5A;
+}
+
+static void comparerPositions(OLEDDisplay &oled, const uint8_t *lignes, const PageBitmap &pages, bool fond)
+{
+    Adafruit_SSD1306 *ecran = oled.getDisplay();
+    const size_t taille = ecran->width() * ecran->height() / 8;
+    uint8_t *attendu = (uint8_t *)malloc(taille);
+    char message[64];
+
+    for (int y = 0; y < ecran->height(); y++)
+    {
+        for (int x = 0; x < ecran->width(); x += 7)
+        {
+            oled.clear();
+            if (fond)
+                fondDessine(oled);
+            oled.printImage(lignes, pages.width, pages.height, x, y); // drawBitmap(), pixel par pixel
+            memcpy(attendu, ecran->getBuffer(), taille);
+
+            oled.clear();
+            if (fond)
+                fondDessine(oled);
+            oled.printImage(pages, x, y);
+
+            snprintf(message, sizeof(message), "%ux%u en x=%d y=%d%s", pages.width, pages.height, x, y,
+                     fond ? " sur fond" : "");
+            TEST_ASSERT_EQUAL_MEMORY_MESSAGE(attendu, ecran->getBuffer(), taille, message);
+        }
+    }
+    free(attendu);
+}
+
+void test_conversion_constexpr()
+{
+    // Bit y % 8 de l'octet x de la page y / 8 <=> bit 7 - x % 8 de l'octet x / 8 de la ligne y
+    const PageBitmap image = IMAGE_CHAT_PAGES.bitmap();
+    const uint8_t octetsParLigne = (IMAGE_WIDTH + 7) / 8;
+    for (int y = 0; y < IMAGE_HEIGHT; y++)
+    {
+        for (int x = 0; x < IMAGE_WIDTH; x++)
+        {
+            const bool ligne = (pgm_read_byte(&IMAGE_CHAT[y * octetsParLigne + x / 8]) & (0x80 >> (x % 8))) != 0;
+            const bool page = (pgm_read_byte(&image.data[(y / 8) * IMAGE_WIDTH + x]) & (1 << (y % 8))) != 0;
+            TEST_ASSERT_EQUAL(ligne, page);
+        }
+    }
+}
+
+void test_image_chat_128x64()
+{
+    OLEDDisplay oled(128, 64);
+    TEST_ASSERT_TRUE(oled.begin());
+    comparerPositions(oled, IMAGE_CHAT, IMAGE_CHAT_PAGES.bitmap(), false);
+    comparerPositions(oled, IMAGE_CHAT, IMAGE_CHAT_PAGES.bitmap(), true);
+}
+
+void test_image_chat_128x32()
+{
+    OLEDDisplay oled(128, 32);
+    TEST_ASSERT_TRUE(oled.begin());
+    comparerPositions(oled, IMAGE_CHAT, IMAGE_CHAT_PAGES.bitmap(), false);
+}
+
+void test_derniere_page_incomplete()
+{
+    OLEDDisplay oled(128, 64);
+    TEST_ASSERT_TRUE(oled.begin());
+    comparerPositions(oled, PETITE_IMAGE, PETITE_IMAGE_PAGES.bitmap(), false);
+    comparerPositions(oled, PETITE_IMAGE, PETITE_IMAGE_PAGES.bitmap(), true);
+}
+
+void test_duree_des_deux_chemins()
+{
+    const int REPETITIONS = 2000;
+    const uint8_t positionsY[] = {0, 8, 12, 21};
+    OLEDDisplay oled(128, 64);
+    TEST_ASSERT_TRUE(oled.begin());
+    const PageBitmap pages = IMAGE_CHAT_PAGES.bitmap();
+
+    for (uint8_t y : positionsY)
+    {
+        unsigned long debut = micros();
+        for (int i = 0; i < REPETITIONS; i++)
+            oled.printImage(IMAGE_CHAT, IMAGE_WIDTH, IMAGE_HEIGHT, 34, y);
+        const unsigned long dureePixels = micros() - debut;
+
+        debut = micros();
+        for (int i = 0; i < REPETITIONS; i++)
+            oled.printImage(pages, 34, y);
+        const unsigned long dureePages = micros() - debut;
+
+        char message[96];
+        snprintf(message, sizeof(message), "y=%u : drawBitmap %.2f us, PageBitmap %.2f us par image",
+                 y, (double)dureePixels / REPETITIONS, (double)dureePages / REPETITIONS);
+        TEST_MESSAGE(message);
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_conversion_constexpr);
+    RUN_TEST(test_image_chat_128x64);
+    RUN_TEST(test_image_chat_128x32);
+    RUN_TEST(test_derniere_page_incomplete);
+    RUN_TEST(test_duree_des_deux_chemins);
+    return UNITY_END();
+}